@@ -0,0 +1,16 @@
+-- dbt-style models of ~10k lines each: a chain of 1000 staging CTEs feeding a final select
+CREATE TABLE corpus_dbt AS
+SELECT '-- model ' || m || chr(10) || 'WITH ' || string_agg(
+	'stg_' || c || ' AS (' || chr(10) ||
+	'    SELECT' || chr(10) ||
+	'        id,' || chr(10) ||
+	'        customer_id,' || chr(10) ||
+	'        CAST(amount AS DECIMAL(18, 2)) AS amount_' || c || ',' || chr(10) ||
+	'        coalesce(status, ''unknown'') AS status' || chr(10) ||
+	'    FROM raw.source_' || (c % 50) || chr(10) ||
+	'    WHERE updated_at >= DATE ''2024-01-01'' AND amount > ' || c || chr(10) ||
+	'      AND customer_id IN (SELECT customer_id FROM stg_customers_' || m || ')' || chr(10) ||
+	')', ',' || chr(10) ORDER BY c) || chr(10) ||
+	'SELECT customer_id, sum(amount_999) AS total FROM stg_999 GROUP BY customer_id' AS q
+FROM range(8) mm(m), range(1000) cc(c)
+GROUP BY m;
@@ -0,0 +1,5 @@
+-- Pathological nesting: parenthesized expressions and derived tables up to 100 levels deep
+CREATE TABLE corpus_nested AS
+SELECT 'SELECT ' || repeat('(', d) || i || ' + x' || repeat(' * 2)', d) || ' FROM ' || repeat('(SELECT * FROM ', d) || 't'
+       || repeat(') s', d) AS q
+FROM (SELECT i, 1 + i % 100 AS d FROM range(1000) t(i));
@@ -0,0 +1,11 @@
+-- Short OLTP statements: point lookups, single-row writes and small joins, all distinct
+CREATE TABLE corpus_oltp AS
+SELECT CASE i % 5
+	WHEN 0 THEN 'SELECT id, name, email FROM users WHERE id = ' || i
+	WHEN 1 THEN 'INSERT INTO orders (user_id, amount, created_at) VALUES (' || i || ', ' || (i % 997) || '.50, now())'
+	WHEN 2 THEN 'UPDATE accounts SET balance = balance - ' || (i % 100) || ' WHERE account_id = ' || i
+	WHEN 3 THEN 'DELETE FROM sessions WHERE expires_at < now() AND user_id = ' || i
+	ELSE 'SELECT o.id, o.amount FROM orders o JOIN users u ON o.user_id = u.id WHERE u.id = ' || i
+	     || ' AND o.status IN (''open'', ''paid'') ORDER BY o.created_at DESC LIMIT 10'
+END AS q
+FROM range(100000) t(i);
@@ -0,0 +1,9 @@
+-- Tiny statements of a few tokens, where the fixed cost of setting up each parse outweighs the parse itself
+CREATE TABLE corpus_tiny AS
+SELECT CASE i % 4
+	WHEN 0 THEN 'SELECT ' || i
+	WHEN 1 THEN 'SELECT a FROM t' || (i % 100)
+	WHEN 2 THEN 'SELECT * FROM t WHERE id = ' || i
+	ELSE 'DELETE FROM t WHERE id = ' || i
+END AS q
+FROM range(200000) t(i);
@@ -0,0 +1,6 @@
+-- The 99 TPC-DS queries, each repeated 20 times with a distinct trailing comment
+INSTALL tpcds;
+LOAD tpcds;
+CREATE TABLE corpus_tpcds AS
+SELECT query || chr(10) || '-- copy ' || r AS q
+FROM tpcds_queries(), range(20) t(r);
@@ -0,0 +1,6 @@
+-- The 22 TPC-H queries, each repeated 100 times with a distinct trailing comment
+INSTALL tpch;
+LOAD tpch;
+CREATE TABLE corpus_tpch AS
+SELECT query || chr(10) || '-- copy ' || r AS q
+FROM tpch_queries(), range(100) t(r);
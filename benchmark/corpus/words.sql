@@ -0,0 +1,4 @@
+-- Candidate words for is_keyword: every keyword plus as many non-keywords
+CREATE TABLE corpus_words AS
+SELECT keyword || CASE WHEN i % 2 = 0 THEN '' ELSE '_' || i END AS q
+FROM sql_keywords(), range(200) t(i);
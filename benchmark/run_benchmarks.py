@@ -0,0 +1,281 @@
+#!/usr/bin/env python3
+"""Throughput benchmarks for the poached functions.
+
+Builds the corpora of benchmark/corpus/ into a scratch database, then times every function over every corpus it
+applies to, in each mode it supports:
+
+- scalar:  the function applied to each row of a corpus table
+- table:   the table function called with a constant argument (the whole corpus as one script, or a file)
+- in-out:  the table function called LATERAL-ly on each row of a corpus table
+
+Each benchmark runs in a fresh duckdb process with the parse cache disabled, so every row is really parsed. The
+reported time is the median of the timed runs as measured by the shell's timer; us_per_row is that time per input
+row, which on the tiny corpus is mostly the fixed overhead of each call; peak_rss_mb is the peak resident memory of
+that process. Results are written as CSV (default) or JSON lines:
+
+    python3 benchmark/run_benchmarks.py --duckdb build/release/duckdb --format json --output bench.jsonl
+
+With --baseline, the run fails if any benchmark's rows_per_sec dropped by more than --max-regression compared to a
+previous result file.
+"""
+
+import argparse
+import csv
+import json
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+
+BENCHMARK_DIR = os.path.dirname(os.path.abspath(__file__))
+CORPUS_DIR = os.path.join(BENCHMARK_DIR, 'corpus')
+
+# corpus name -> setup script in benchmark/corpus/; corpora whose setup fails (e.g. tpch is not available) are skipped
+CORPORA = ['oltp', 'tiny', 'dbt', 'tpch', 'tpcds', 'nested', 'words']
+QUERY_CORPORA = ['oltp', 'tiny', 'dbt', 'tpch', 'tpcds', 'nested']
+# corpora that are also concatenated into one script (and one file) for the constant-argument table modes
+SCRIPT_CORPORA = ['oltp', 'dbt', 'tpch']
+
+SCALAR_FUNCTIONS = {
+    'is_valid_sql': 'is_valid_sql(q)',
+    'sql_error_message': 'sql_error_message(q)',
+    'sql_error_position': 'sql_error_position(q)',
+    'num_statements': 'num_statements(q)',
+    'parse_statement_types': 'parse_statement_types(q)',
+    'num_parameters': 'num_parameters(q)',
+    'parse_table_names': 'parse_table_names(q)',
+    'parse_function_names': 'parse_function_names(q)',
+    'parse_column_names': 'parse_column_names(q, 0)',
+    'parse_analyze': 'parse_analyze(q)',
+    'parse_sql_json': 'parse_sql_json(q)',
+    'sql_strip_comments': 'sql_strip_comments(q)',
+    'parse_normalize': 'parse_normalize(q)',
+    'parse_fingerprint': 'parse_fingerprint(q)',
+    'parse_signature': 'parse_signature(q)',
+    'parse_token_list': 'parse_token_list(q)',
+    'parse_ast': 'parse_ast(q)',
+}
+
+TABLE_FUNCTIONS = {
+    'parse_tokens': 'parse_tokens({arg})',
+    'parse_statements': 'parse_statements({arg})',
+    'parse_tables': 'parse_tables({arg})',
+    'parse_functions': 'parse_functions({arg})',
+    'parse_where': 'parse_where({arg})',
+    'parse_columns': 'parse_columns({arg}, 0)',
+    'parse_lineage': 'parse_lineage({arg})',
+    'parse_parameters': 'parse_parameters({arg})',
+}
+
+FILE_FUNCTIONS = ['parse_sql_file', 'parse_sql_file_tables']
+
+TIMER_PATTERN = re.compile(r'Run Time \(s\): real ([0-9.]+)')
+
+
+class Benchmark:
+    def __init__(self, function, mode, corpus, query, setup=''):
+        self.function = function
+        self.mode = mode
+        self.corpus = corpus
+        self.query = query
+        self.setup = setup
+
+    @property
+    def name(self):
+        return '%s/%s/%s' % (self.function, self.mode, self.corpus)
+
+
+def corpus_table(corpus):
+    return 'corpus_' + corpus
+
+
+def script_setup(corpus):
+    return "SET VARIABLE script = (SELECT string_agg(q, ';' || chr(10)) FROM %s);" % corpus_table(corpus)
+
+
+def build_benchmarks(corpora, file_dir):
+    benchmarks = []
+    for corpus in QUERY_CORPORA:
+        if corpus not in corpora:
+            continue
+        table = corpus_table(corpus)
+        for function, expression in SCALAR_FUNCTIONS.items():
+            query = 'SELECT count(%s) FROM %s' % (expression, table)
+            benchmarks.append(Benchmark(function, 'scalar', corpus, query))
+        for function, call in TABLE_FUNCTIONS.items():
+            query = 'SELECT count(*) FROM %s, %s' % (table, call.format(arg='q'))
+            benchmarks.append(Benchmark(function, 'in-out', corpus, query))
+        if corpus in SCRIPT_CORPORA:
+            for function, call in TABLE_FUNCTIONS.items():
+                query = 'SELECT count(*) FROM %s' % call.format(arg="getvariable('script')")
+                benchmarks.append(Benchmark(function, 'table', corpus, query, script_setup(corpus)))
+            for function in FILE_FUNCTIONS:
+                path = os.path.join(file_dir, corpus + '.sql')
+                query = "SELECT count(*) FROM %s('%s')" % (function, path)
+                benchmarks.append(Benchmark(function, 'table', corpus, query))
+    if 'words' in corpora:
+        benchmarks.append(Benchmark('is_keyword', 'scalar', 'words', 'SELECT count(is_keyword(q)) FROM corpus_words'))
+        benchmarks.append(Benchmark('keyword_category', 'scalar', 'words',
+                                    'SELECT count(keyword_category(q)) FROM corpus_words'))
+    if 'dbt' in corpora:
+        # a one-character edit in the middle of each model, re-tokenized against the model's previous tokens
+        setup = (
+            'CREATE TEMP TABLE edits AS '
+            'SELECT left(q, p) || \'x\' || substr(q, p + 1) AS q, p, tokens '
+            'FROM (SELECT q, strlen(q) // 2 AS p, (SELECT list(t) FROM parse_tokens(c.q) t) AS tokens '
+            'FROM corpus_dbt c);'
+        )
+        query = 'SELECT count(parse_tokens_delta(q, p, p, p + 1, tokens)) FROM edits'
+        benchmarks.append(Benchmark('parse_tokens_delta', 'scalar', 'dbt', query, setup))
+    benchmarks.append(Benchmark('parse_keywords', 'table', 'keywords', 'SELECT count(*) FROM parse_keywords()'))
+    benchmarks.append(Benchmark('parse_keyword_names', 'scalar', 'keywords',
+                                'SELECT count(parse_keyword_names()) FROM range(1000)'))
+    return benchmarks
+
+
+def run_duckdb(duckdb, database, script, read_only=True):
+    """Run a script in a fresh duckdb process, returning (output, peak RSS in MB)"""
+    args = [duckdb, '-batch', '-noheader', '-list']
+    if read_only:
+        args.append('-readonly')
+    args.append(database)
+    process = subprocess.Popen(args, stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    process.stdin.write(script.encode('utf8'))
+    process.stdin.close()
+    output = process.stdout.read().decode('utf8', errors='replace')
+    _, status, usage = os.wait4(process.pid, 0)
+    process.returncode = os.waitstatus_to_exitcode(status)
+    if process.returncode != 0 or 'Error' in output:
+        raise RuntimeError(output.strip())
+    # ru_maxrss is in kilobytes on Linux and in bytes on macOS
+    peak_rss = usage.ru_maxrss / (1024 * 1024 if sys.platform == 'darwin' else 1024)
+    return output, peak_rss
+
+
+def setup_corpora(duckdb, database, file_dir, requested):
+    corpora = []
+    for corpus in requested:
+        with open(os.path.join(CORPUS_DIR, corpus + '.sql')) as f:
+            script = f.read()
+        try:
+            run_duckdb(duckdb, database, script, read_only=False)
+        except RuntimeError as e:
+            message = str(e).splitlines()
+            print('skipping corpus %s: %s' % (corpus, message[0] if message else 'setup failed'), file=sys.stderr)
+            continue
+        corpora.append(corpus)
+        if corpus in SCRIPT_CORPORA:
+            output, _ = run_duckdb(duckdb, database, 'SELECT q || \';\' FROM %s;' % corpus_table(corpus))
+            with open(os.path.join(file_dir, corpus + '.sql'), 'w') as f:
+                f.write(output)
+    return corpora
+
+
+def corpus_sizes(duckdb, database, corpora):
+    sizes = {}
+    for corpus in corpora:
+        output, _ = run_duckdb(duckdb, database, 'SELECT count(*), sum(strlen(q)) FROM %s;' % corpus_table(corpus))
+        rows, size = output.strip().split('|')
+        sizes[corpus] = (int(rows), int(size))
+    output, _ = run_duckdb(duckdb, database, 'SELECT count(*), sum(strlen(keyword)) FROM parse_keywords();')
+    rows, size = output.strip().split('|')
+    sizes['keywords'] = (int(rows), int(size))
+    return sizes
+
+
+def run_benchmark(duckdb, database, benchmark, runs, threads):
+    script = ['SET poached_parse_cache_size = 0;']
+    if threads:
+        script.append('SET threads = %d;' % threads)
+    if benchmark.setup:
+        script.append(benchmark.setup)
+    script.append('.timer on')
+    # the first run warms up the process and is not reported
+    for _ in range(runs + 1):
+        script.append(benchmark.query + ';')
+    output, peak_rss = run_duckdb(duckdb, database, '\n'.join(script) + '\n')
+    timings = [float(t) for t in TIMER_PATTERN.findall(output)]
+    if len(timings) != runs + 1:
+        raise RuntimeError('expected %d timings, got output:\n%s' % (runs + 1, output))
+    result_lines = [line for line in output.splitlines() if line.strip() and not TIMER_PATTERN.match(line)]
+    return timings[1:], int(result_lines[-1]), peak_rss
+
+
+def read_results(path):
+    """Read a previous result file (CSV or JSON lines) into {benchmark: rows_per_sec}"""
+    with open(path) as f:
+        content = f.read()
+    if content.lstrip().startswith('{'):
+        rows = [json.loads(line) for line in content.splitlines() if line.strip()]
+    else:
+        rows = list(csv.DictReader(content.splitlines()))
+    return {row['benchmark']: float(row['rows_per_sec']) for row in rows}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Run the poached throughput benchmarks')
+    parser.add_argument('--duckdb', default='build/release/duckdb', help='duckdb shell with poached linked in')
+    parser.add_argument('--runs', type=int, default=5, help='timed runs per benchmark')
+    parser.add_argument('--threads', type=int, default=0, help='threads setting (0 keeps the default)')
+    parser.add_argument('--filter', default='', help='only run benchmarks whose name matches this regex')
+    parser.add_argument('--format', choices=['csv', 'json'], default='csv')
+    parser.add_argument('--output', default='-', help='result file, - for stdout')
+    parser.add_argument('--baseline', help='previous result file to compare rows_per_sec against')
+    parser.add_argument('--max-regression', type=float, default=0.1,
+                        help='fail if a benchmark is this fraction slower than the baseline')
+    args = parser.parse_args()
+
+    fields = ['benchmark', 'function', 'mode', 'corpus', 'input_rows', 'input_bytes', 'output_rows', 'runs',
+              'median_s', 'min_s', 'rows_per_sec', 'mb_per_sec', 'us_per_row', 'peak_rss_mb']
+    out = sys.stdout if args.output == '-' else open(args.output, 'w', newline='')
+    writer = csv.DictWriter(out, fields) if args.format == 'csv' else None
+    baseline = read_results(args.baseline) if args.baseline else {}
+    regressions = []
+    if writer:
+        writer.writeheader()
+
+    with tempfile.TemporaryDirectory(prefix='poached_bench_') as scratch:
+        database = os.path.join(scratch, 'corpus.duckdb')
+        corpora = setup_corpora(args.duckdb, database, scratch, CORPORA)
+        sizes = corpus_sizes(args.duckdb, database, corpora)
+        for benchmark in build_benchmarks(corpora, scratch):
+            if args.filter and not re.search(args.filter, benchmark.name):
+                continue
+            timings, output_rows, peak_rss = run_benchmark(args.duckdb, database, benchmark, args.runs, args.threads)
+            rows, size = sizes[benchmark.corpus]
+            median = max(statistics.median(timings), 1e-9)
+            result = {
+                'benchmark': benchmark.name,
+                'function': benchmark.function,
+                'mode': benchmark.mode,
+                'corpus': benchmark.corpus,
+                'input_rows': rows,
+                'input_bytes': size,
+                'output_rows': output_rows,
+                'runs': args.runs,
+                'median_s': round(median, 6),
+                'min_s': round(min(timings), 6),
+                'rows_per_sec': round(rows / median, 1),
+                'mb_per_sec': round(size / (1024 * 1024) / median, 3),
+                'us_per_row': round(median * 1e6 / rows, 3),
+                'peak_rss_mb': round(peak_rss, 1),
+            }
+            if writer:
+                writer.writerow(result)
+            else:
+                out.write(json.dumps(result) + '\n')
+            out.flush()
+            previous = baseline.get(benchmark.name)
+            if previous and result['rows_per_sec'] < previous * (1 - args.max_regression):
+                regressions.append('%s: %.1f rows/sec, baseline %.1f' % (benchmark.name, result['rows_per_sec'], previous))
+    if out is not sys.stdout:
+        out.close()
+    if regressions:
+        print('throughput regressions:\n  ' + '\n  '.join(regressions), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
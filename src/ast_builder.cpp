@@ -0,0 +1,524 @@
+#include "ast_builder.hpp"
+#include "duckdb/common/enum_util.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/query_node.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/query_node/set_operation_node.hpp"
+#include "duckdb/parser/query_node/recursive_cte_node.hpp"
+#include "duckdb/parser/result_modifier.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/statement/insert_statement.hpp"
+#include "duckdb/parser/statement/update_statement.hpp"
+#include "duckdb/parser/statement/delete_statement.hpp"
+#include "duckdb/parser/statement/create_statement.hpp"
+#include "duckdb/parser/statement/merge_into_statement.hpp"
+#include "duckdb/parser/statement/copy_statement.hpp"
+#include "duckdb/parser/statement/explain_statement.hpp"
+#include "duckdb/parser/statement/prepare_statement.hpp"
+#include "duckdb/parser/statement/execute_statement.hpp"
+#include "duckdb/parser/statement/call_statement.hpp"
+#include "duckdb/parser/statement/drop_statement.hpp"
+#include "duckdb/parser/statement/alter_statement.hpp"
+#include "duckdb/parser/statement/vacuum_statement.hpp"
+#include "duckdb/parser/statement/set_statement.hpp"
+#include "duckdb/parser/parsed_data/create_table_info.hpp"
+#include "duckdb/parser/parsed_data/create_view_info.hpp"
+#include "duckdb/parser/parsed_data/create_index_info.hpp"
+#include "duckdb/parser/query_node/cte_node.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+#include "duckdb/parser/tableref/table_function_ref.hpp"
+#include "duckdb/parser/tableref/expressionlistref.hpp"
+#include "duckdb/parser/tableref/pivotref.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/subquery_expression.hpp"
+
+namespace duckdb {
+
+// Join the non-empty parts of a qualified name with dots
+static string QualifiedName(const vector<string> &parts) {
+	vector<string> present;
+	for (auto &part : parts) {
+		if (!part.empty()) {
+			present.push_back(part);
+		}
+	}
+	return StringUtil::Join(present, ".");
+}
+
+AstBuilder::AstBuilder(vector<AstNode> &nodes, SpanLocator *spans) : nodes(nodes), spans(spans) {
+}
+
+idx_t AstBuilder::AddNode(idx_t parent, const char *node_type, string kind, const char *role, string name,
+                          string alias) {
+	AstNode node;
+	node.id = nodes.size();
+	node.parent = parent;
+	node.node_type = node_type;
+	node.kind = std::move(kind);
+	node.role = role;
+	node.name = std::move(name);
+	node.alias = std::move(alias);
+	if (parent != AST_NO_PARENT) {
+		nodes[parent].children.push_back(node.id);
+	}
+	nodes.push_back(std::move(node));
+	return nodes.back().id;
+}
+
+void AstBuilder::AddTarget(idx_t parent, const vector<string> &qualified_name, const char *keyword) {
+	auto id = AddNode(parent, "table_ref", EnumUtil::ToString(TableReferenceType::BASE_TABLE), "target",
+	                  QualifiedName(qualified_name));
+	if (spans) {
+		nodes[id].span = spans->FindName(stmt_location, keyword, qualified_name.back());
+	}
+}
+
+void AstBuilder::AddStatement(SQLStatement &stmt) {
+	stmt_location = stmt.stmt_location;
+	AddStatement(AST_NO_PARENT, stmt, "");
+}
+
+void AstBuilder::AddStatement(idx_t parent, SQLStatement &stmt, const char *role) {
+	auto id = AddNode(parent, "statement", StatementTypeToString(stmt.type), role);
+	if (spans) {
+		nodes[id].span = spans->RangeSpan(stmt.stmt_location, stmt.stmt_length);
+	}
+	switch (stmt.type) {
+	case StatementType::SELECT_STATEMENT:
+		AddSelect(id, stmt.Cast<SelectStatement>(), "query");
+		break;
+	case StatementType::INSERT_STATEMENT: {
+		auto &insert = stmt.Cast<InsertStatement>();
+		AddCTEs(id, insert.cte_map);
+		AddTarget(id, {insert.catalog, insert.schema, insert.table}, "INTO");
+		if (insert.select_statement) {
+			AddSelect(id, *insert.select_statement, "source");
+		}
+		if (insert.on_conflict_info && insert.on_conflict_info->set_info) {
+			AddUpdateSet(id, *insert.on_conflict_info->set_info);
+		}
+		AddExpressions(id, insert.returning_list, "returning");
+		break;
+	}
+	case StatementType::UPDATE_STATEMENT: {
+		auto &update = stmt.Cast<UpdateStatement>();
+		AddCTEs(id, update.cte_map);
+		if (update.table) {
+			AddTableRef(id, *update.table, "target");
+		}
+		if (update.set_info) {
+			AddExpressions(id, update.set_info->expressions, "set");
+		}
+		if (update.from_table) {
+			AddTableRef(id, *update.from_table, "from");
+		}
+		if (update.set_info && update.set_info->condition) {
+			AddExpression(id, *update.set_info->condition, "where");
+		}
+		AddExpressions(id, update.returning_list, "returning");
+		break;
+	}
+	case StatementType::DELETE_STATEMENT: {
+		auto &del = stmt.Cast<DeleteStatement>();
+		AddCTEs(id, del.cte_map);
+		if (del.table) {
+			AddTableRef(id, *del.table, "target");
+		}
+		for (auto &ref : del.using_clauses) {
+			AddTableRef(id, *ref, "using");
+		}
+		if (del.condition) {
+			AddExpression(id, *del.condition, "where");
+		}
+		AddExpressions(id, del.returning_list, "returning");
+		break;
+	}
+	case StatementType::CREATE_STATEMENT: {
+		auto &create = stmt.Cast<CreateStatement>();
+		if (!create.info) {
+			break;
+		}
+		if (create.info->type == CatalogType::TABLE_ENTRY) {
+			auto &info = create.info->Cast<CreateTableInfo>();
+			AddTarget(id, {info.catalog, info.schema, info.table}, "TABLE");
+			if (info.query) {
+				AddSelect(id, *info.query, "source");
+			}
+		} else if (create.info->type == CatalogType::VIEW_ENTRY) {
+			auto &info = create.info->Cast<CreateViewInfo>();
+			AddTarget(id, {info.catalog, info.schema, info.view_name}, "VIEW");
+			if (info.query) {
+				AddSelect(id, *info.query, "source");
+			}
+		} else if (create.info->type == CatalogType::INDEX_ENTRY) {
+			auto &info = create.info->Cast<CreateIndexInfo>();
+			AddTarget(id, {info.catalog, info.schema, info.table}, "ON");
+		}
+		break;
+	}
+	case StatementType::MERGE_INTO_STATEMENT: {
+		auto &merge = stmt.Cast<MergeIntoStatement>();
+		AddCTEs(id, merge.cte_map);
+		if (merge.target) {
+			AddTableRef(id, *merge.target, "target");
+		}
+		if (merge.source) {
+			AddTableRef(id, *merge.source, "using");
+		}
+		if (merge.join_condition) {
+			AddExpression(id, *merge.join_condition, "condition");
+		}
+		for (auto &entry : merge.actions) {
+			for (auto &action : entry.second) {
+				if (action->condition) {
+					AddExpression(id, *action->condition, "when");
+				}
+				if (action->update_info) {
+					AddUpdateSet(id, *action->update_info);
+				}
+				AddExpressions(id, action->expressions, "value");
+			}
+		}
+		AddExpressions(id, merge.returning_list, "returning");
+		break;
+	}
+	case StatementType::COPY_STATEMENT: {
+		auto &copy = stmt.Cast<CopyStatement>();
+		if (!copy.info) {
+			break;
+		}
+		if (!copy.info->table.empty()) {
+			AddTarget(id, {copy.info->catalog, copy.info->schema, copy.info->table}, "COPY");
+		} else if (copy.info->select_statement) {
+			AddQueryNode(id, *copy.info->select_statement, "source");
+		}
+		break;
+	}
+	case StatementType::DROP_STATEMENT: {
+		auto &drop = stmt.Cast<DropStatement>();
+		if (drop.info && (drop.info->type == CatalogType::TABLE_ENTRY || drop.info->type == CatalogType::VIEW_ENTRY)) {
+			auto keyword = drop.info->type == CatalogType::TABLE_ENTRY ? "TABLE" : "VIEW";
+			AddTarget(id, {drop.info->catalog, drop.info->schema, drop.info->name}, keyword);
+		}
+		break;
+	}
+	case StatementType::ALTER_STATEMENT: {
+		auto &alter = stmt.Cast<AlterStatement>();
+		if (alter.info && (alter.info->type == AlterType::ALTER_TABLE || alter.info->type == AlterType::ALTER_VIEW)) {
+			auto keyword = alter.info->type == AlterType::ALTER_TABLE ? "TABLE" : "VIEW";
+			AddTarget(id, {alter.info->catalog, alter.info->schema, alter.info->name}, keyword);
+		}
+		break;
+	}
+	case StatementType::VACUUM_STATEMENT: {
+		auto &vacuum = stmt.Cast<VacuumStatement>();
+		if (vacuum.info && vacuum.info->ref) {
+			AddTableRef(id, *vacuum.info->ref, "target");
+		}
+		break;
+	}
+	case StatementType::EXPLAIN_STATEMENT: {
+		auto &explain = stmt.Cast<ExplainStatement>();
+		if (explain.stmt) {
+			AddStatement(id, *explain.stmt, "statement");
+		}
+		break;
+	}
+	case StatementType::PREPARE_STATEMENT: {
+		auto &prepare = stmt.Cast<PrepareStatement>();
+		if (prepare.statement) {
+			AddStatement(id, *prepare.statement, "statement");
+		}
+		break;
+	}
+	case StatementType::EXECUTE_STATEMENT:
+		for (auto &value : stmt.Cast<ExecuteStatement>().named_values) {
+			AddExpression(id, *value.second, "value");
+		}
+		break;
+	case StatementType::CALL_STATEMENT: {
+		auto &call = stmt.Cast<CallStatement>();
+		if (call.function) {
+			AddExpression(id, *call.function, "function");
+		}
+		break;
+	}
+	case StatementType::SET_STATEMENT: {
+		auto &set = stmt.Cast<SetStatement>();
+		if (set.set_type == SetType::SET) {
+			auto &value = set.Cast<SetVariableStatement>().value;
+			if (value) {
+				AddExpression(id, *value, "value");
+			}
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void AstBuilder::AddUpdateSet(idx_t parent, UpdateSetInfo &set_info) {
+	AddExpressions(parent, set_info.expressions, "set");
+	if (set_info.condition) {
+		AddExpression(parent, *set_info.condition, "where");
+	}
+}
+
+void AstBuilder::AddSelect(idx_t parent, SelectStatement &select, const char *role, const string &name) {
+	if (select.node) {
+		AddQueryNode(parent, *select.node, role, name);
+	}
+}
+
+void AstBuilder::AddQueryNode(idx_t parent, QueryNode &node, const char *role, const string &name) {
+	auto id = AddNode(parent, "query_node", EnumUtil::ToString(node.type), role, name);
+	AddCTEs(id, node.cte_map);
+	switch (node.type) {
+	case QueryNodeType::SELECT_NODE: {
+		auto &select = node.Cast<SelectNode>();
+		AddExpressions(id, select.select_list, "select_list");
+		if (select.from_table) {
+			AddTableRef(id, *select.from_table, "from");
+		}
+		if (select.where_clause) {
+			AddExpression(id, *select.where_clause, "where");
+		}
+		AddExpressions(id, select.groups.group_expressions, "group_by");
+		if (select.having) {
+			AddExpression(id, *select.having, "having");
+		}
+		if (select.qualify) {
+			AddExpression(id, *select.qualify, "qualify");
+		}
+		break;
+	}
+	case QueryNodeType::SET_OPERATION_NODE: {
+		auto &setop = node.Cast<SetOperationNode>();
+		if (name.empty()) {
+			nodes[id].name = EnumUtil::ToString(setop.setop_type) + (setop.setop_all ? " ALL" : "");
+		}
+		for (auto &child : setop.children) {
+			AddQueryNode(id, *child, "operand");
+		}
+		break;
+	}
+	case QueryNodeType::RECURSIVE_CTE_NODE: {
+		auto &cte = node.Cast<RecursiveCTENode>();
+		if (cte.left) {
+			AddQueryNode(id, *cte.left, "left");
+		}
+		if (cte.right) {
+			AddQueryNode(id, *cte.right, "right");
+		}
+		break;
+	}
+	case QueryNodeType::CTE_NODE: {
+		auto &cte = node.Cast<CTENode>();
+		if (cte.query) {
+			AddQueryNode(id, *cte.query, "cte", cte.ctename);
+		}
+		if (cte.child) {
+			AddQueryNode(id, *cte.child, "query");
+		}
+		break;
+	}
+	default:
+		break;
+	}
+
+	for (auto &modifier : node.modifiers) {
+		switch (modifier->type) {
+		case ResultModifierType::ORDER_MODIFIER:
+			for (auto &order : modifier->Cast<OrderModifier>().orders) {
+				AddExpression(id, *order.expression, "order_by");
+			}
+			break;
+		case ResultModifierType::DISTINCT_MODIFIER:
+			AddExpressions(id, modifier->Cast<DistinctModifier>().distinct_on_targets, "distinct_on");
+			break;
+		case ResultModifierType::LIMIT_MODIFIER: {
+			auto &limit = modifier->Cast<LimitModifier>();
+			if (limit.limit) {
+				AddExpression(id, *limit.limit, "limit");
+			}
+			if (limit.offset) {
+				AddExpression(id, *limit.offset, "offset");
+			}
+			break;
+		}
+		case ResultModifierType::LIMIT_PERCENT_MODIFIER: {
+			auto &limit = modifier->Cast<LimitPercentModifier>();
+			if (limit.limit) {
+				AddExpression(id, *limit.limit, "limit");
+			}
+			if (limit.offset) {
+				AddExpression(id, *limit.offset, "offset");
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
+
+void AstBuilder::AddCTEs(idx_t parent, CommonTableExpressionMap &cte_map) {
+	for (auto &cte : cte_map.map) {
+		if (cte.second && cte.second->query) {
+			AddSelect(parent, *cte.second->query, "cte", cte.first);
+		}
+	}
+}
+
+void AstBuilder::AddTableRef(idx_t parent, TableRef &ref, const char *role) {
+	auto id = AddNode(parent, "table_ref", EnumUtil::ToString(ref.type), role, string(), ref.alias);
+	switch (ref.type) {
+	case TableReferenceType::BASE_TABLE: {
+		auto &base = ref.Cast<BaseTableRef>();
+		nodes[id].name = QualifiedName({base.catalog_name, base.schema_name, base.table_name});
+		if (spans && ref.query_location.IsValid()) {
+			nodes[id].span = spans->ConstructSpan(ref.query_location.GetIndex());
+		}
+		break;
+	}
+	case TableReferenceType::JOIN: {
+		auto &join = ref.Cast<JoinRef>();
+		nodes[id].name = EnumUtil::ToString(join.type);
+		if (join.left) {
+			AddTableRef(id, *join.left, "left");
+		}
+		if (join.right) {
+			AddTableRef(id, *join.right, "right");
+		}
+		if (join.condition) {
+			AddExpression(id, *join.condition, "condition");
+		}
+		break;
+	}
+	case TableReferenceType::SUBQUERY: {
+		auto &subquery = ref.Cast<SubqueryRef>();
+		if (spans && ref.query_location.IsValid()) {
+			nodes[id].span = spans->ConstructSpan(ref.query_location.GetIndex());
+		}
+		if (subquery.subquery) {
+			AddSelect(id, *subquery.subquery, "subquery");
+		}
+		break;
+	}
+	case TableReferenceType::TABLE_FUNCTION: {
+		auto &func = ref.Cast<TableFunctionRef>();
+		if (func.function) {
+			if (func.function->type == ExpressionType::FUNCTION) {
+				auto &fn = func.function->Cast<FunctionExpression>();
+				nodes[id].name = QualifiedName({fn.catalog, fn.schema, fn.function_name});
+			}
+			idx_t start = NumericLimits<idx_t>::Maximum();
+			idx_t end = 0;
+			AddExpression(id, *func.function, "function", start, end);
+			if (spans && start < end) {
+				nodes[id].span = spans->Span(start, end);
+			}
+		}
+		break;
+	}
+	case TableReferenceType::PIVOT: {
+		auto &pivot = ref.Cast<PivotRef>();
+		if (pivot.source) {
+			AddTableRef(id, *pivot.source, "source");
+		}
+		AddExpressions(id, pivot.aggregates, "aggregate");
+		for (auto &column : pivot.pivots) {
+			AddExpressions(id, column.pivot_expressions, "pivot");
+			for (auto &entry : column.entries) {
+				if (entry.expr) {
+					AddExpression(id, *entry.expr, "pivot_value");
+				}
+			}
+			if (column.subquery) {
+				AddQueryNode(id, *column.subquery, "subquery");
+			}
+		}
+		break;
+	}
+	case TableReferenceType::EXPRESSION_LIST: {
+		auto &values = ref.Cast<ExpressionListRef>();
+		for (auto &row : values.values) {
+			AddExpressions(id, row, "value");
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void AstBuilder::AddExpression(idx_t parent, const ParsedExpression &expr, const char *role, idx_t &start,
+                               idx_t &end) {
+	auto id = AddNode(parent, "expression", EnumUtil::ToString(expr.type), role, string(), expr.alias);
+	const char *child_role = "operand";
+	switch (expr.GetExpressionClass()) {
+	case ExpressionClass::FUNCTION: {
+		auto &fn = expr.Cast<FunctionExpression>();
+		nodes[id].name = QualifiedName({fn.catalog, fn.schema, fn.function_name});
+		child_role = "argument";
+		break;
+	}
+	case ExpressionClass::COLUMN_REF:
+		nodes[id].name = QualifiedName(expr.Cast<ColumnRefExpression>().column_names);
+		break;
+	case ExpressionClass::CONSTANT:
+		nodes[id].name = expr.Cast<ConstantExpression>().value.ToString();
+		break;
+	default:
+		break;
+	}
+
+	// the span covers the construct at the expression's location and those of its children; operators are located
+	// at the operator, so their span starts at their first operand
+	idx_t node_start = NumericLimits<idx_t>::Maximum();
+	idx_t node_end = 0;
+	if (spans && expr.query_location.IsValid()) {
+		auto construct = spans->ConstructSpan(expr.query_location.GetIndex());
+		if (construct.IsValid()) {
+			node_start = construct.start_byte;
+			node_end = construct.end_byte;
+		}
+	}
+	ParsedExpressionIterator::EnumerateChildren(
+	    expr, [&](const ParsedExpression &child) { AddExpression(id, child, child_role, node_start, node_end); });
+	if (expr.GetExpressionClass() == ExpressionClass::SUBQUERY) {
+		auto &subquery = expr.Cast<SubqueryExpression>();
+		if (subquery.subquery) {
+			AddSelect(id, *subquery.subquery, "subquery");
+		}
+	}
+
+	if (spans && node_start < node_end) {
+		nodes[id].span = spans->Span(node_start, node_end);
+	}
+	start = MinValue(start, node_start);
+	end = MaxValue(end, node_end);
+}
+
+void AstBuilder::AddExpression(idx_t parent, const ParsedExpression &expr, const char *role) {
+	idx_t start = NumericLimits<idx_t>::Maximum();
+	idx_t end = 0;
+	AddExpression(parent, expr, role, start, end);
+}
+
+void BuildAst(const vector<unique_ptr<SQLStatement>> &statements, vector<AstNode> &nodes, SpanLocator *spans) {
+	AstBuilder builder(nodes, spans);
+	for (auto &stmt : statements) {
+		if (stmt) {
+			builder.AddStatement(*stmt);
+		}
+	}
+}
+
+} // namespace duckdb
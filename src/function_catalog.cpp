@@ -0,0 +1,128 @@
+#include "function_catalog.hpp"
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/client_context_state.hpp"
+
+namespace duckdb {
+
+const char *FunctionKindName(FunctionKind kind) {
+	switch (kind) {
+	case FunctionKind::SCALAR:
+		return "scalar";
+	case FunctionKind::AGGREGATE:
+		return "aggregate";
+	case FunctionKind::TABLE:
+		return "table";
+	case FunctionKind::MACRO:
+		return "macro";
+	case FunctionKind::TABLE_MACRO:
+		return "table_macro";
+	default:
+		return "unknown";
+	}
+}
+
+// FNV-1a over the lower-cased bytes
+static uint64_t HashFunctionName(const char *data, idx_t size) {
+	uint64_t hash = 14695981039346656037ULL;
+	for (idx_t i = 0; i < size; i++) {
+		hash = (hash ^ static_cast<uint8_t>(StringUtil::CharacterToLower(data[i]))) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+idx_t FunctionCatalog::FindSlot(const char *name, idx_t size) const {
+	auto mask = slots.size() - 1;
+	for (auto slot = HashFunctionName(name, size) & mask;; slot = (slot + 1) & mask) {
+		if (slots[slot] == 0) {
+			return slot;
+		}
+		auto &entry = entries[slots[slot] - 1].name;
+		if (entry.size() != size) {
+			continue;
+		}
+		idx_t i = 0;
+		while (i < size && StringUtil::CharacterToLower(name[i]) == entry[i]) {
+			i++;
+		}
+		if (i == size) {
+			return slot;
+		}
+	}
+}
+
+FunctionKind FunctionCatalog::Lookup(const char *name, idx_t size) const {
+	if (slots.empty()) {
+		return FunctionKind::UNKNOWN;
+	}
+	auto slot = slots[FindSlot(name, size)];
+	return slot == 0 ? FunctionKind::UNKNOWN : entries[slot - 1].kind;
+}
+
+void FunctionCatalog::Grow() {
+	vector<uint32_t> old_slots(MaxValue<idx_t>(slots.size() * 2, 1024), 0);
+	std::swap(slots, old_slots);
+	for (auto index : old_slots) {
+		if (index != 0) {
+			auto &name = entries[index - 1].name;
+			slots[FindSlot(name.data(), name.size())] = index;
+		}
+	}
+}
+
+void FunctionCatalog::Add(const string &name, FunctionKind kind) {
+	if ((entries.size() + 1) * 2 > slots.size()) {
+		Grow();
+	}
+	auto slot = FindSlot(name.data(), name.size());
+	if (slots[slot] != 0) {
+		return;
+	}
+	entries.push_back(Entry {StringUtil::Lower(name), kind});
+	slots[slot] = NumericCast<uint32_t>(entries.size());
+}
+
+// The cached functions of a context and the catalog versions they were collected at
+struct FunctionCatalogState : public ClientContextState {
+	mutex lock;
+	string catalog_versions;
+	shared_ptr<const FunctionCatalog> functions;
+};
+
+shared_ptr<const FunctionCatalog> FunctionCatalog::Get(ClientContext &context) {
+	auto schemas = Catalog::GetAllSchemas(context);
+	// the catalogs and their versions; a catalog without versions is assumed not to change
+	string catalog_versions;
+	for (auto &schema : schemas) {
+		auto &catalog = schema.get().ParentCatalog();
+		auto version = catalog.GetCatalogVersion(context);
+		catalog_versions += catalog.GetName() + ":" + schema.get().name + ":" +
+		                    (version.IsValid() ? std::to_string(version.GetIndex()) : string()) + ";";
+	}
+
+	auto state = context.registered_state->GetOrCreate<FunctionCatalogState>("poached_function_catalog");
+	lock_guard<mutex> guard(state->lock);
+	if (state->functions && state->catalog_versions == catalog_versions) {
+		return state->functions;
+	}
+	static const pair<CatalogType, FunctionKind> FUNCTION_TYPES[] = {
+	    {CatalogType::SCALAR_FUNCTION_ENTRY, FunctionKind::SCALAR},
+	    {CatalogType::AGGREGATE_FUNCTION_ENTRY, FunctionKind::AGGREGATE},
+	    {CatalogType::MACRO_ENTRY, FunctionKind::MACRO},
+	    {CatalogType::TABLE_FUNCTION_ENTRY, FunctionKind::TABLE},
+	    {CatalogType::TABLE_MACRO_ENTRY, FunctionKind::TABLE_MACRO}};
+	auto functions = make_shared_ptr<FunctionCatalog>();
+	for (auto &schema : schemas) {
+		for (auto &type : FUNCTION_TYPES) {
+			schema.get().Scan(context, type.first,
+			                  [&](CatalogEntry &entry) { functions->Add(entry.name, type.second); });
+		}
+	}
+	state->functions = std::move(functions);
+	state->catalog_versions = std::move(catalog_versions);
+	return state->functions;
+}
+
+} // namespace duckdb
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/parser/sql_statement.hpp"
+#include "source_span.hpp"
+
+namespace duckdb {
+
+class ParsedExpression;
+class QueryNode;
+class SelectStatement;
+class TableRef;
+class CommonTableExpressionMap;
+class UpdateSetInfo;
+
+//! Sentinel parent of statement nodes
+static constexpr idx_t AST_NO_PARENT = DConstants::INVALID_INDEX;
+
+//! A node of a flattened statement tree. Nodes are numbered in pre-order over all statements of the query, parents
+//! and children refer to each other by that number.
+struct AstNode {
+	idx_t id;
+	idx_t parent = AST_NO_PARENT;
+	//! "statement", "query_node", "table_ref" or "expression"
+	string node_type;
+	//! The statement, query node, table reference or expression type, e.g. SELECT, SELECT_NODE, JOIN, COLUMN_REF
+	string kind;
+	//! What the node is to its parent, e.g. "from", "where", "select_list", "left"; empty for statements
+	string role;
+	//! Table, function or column name, or constant value; empty if the node has none
+	string name;
+	string alias;
+	vector<idx_t> children;
+	SourceSpan span;
+};
+
+//! Builds the AstNode tree of statements. Descends the same clauses as QueryAnalyzer, with the statement of an EXPLAIN
+//! or PREPARE as a child statement node; statements of other types are a single node. With a SpanLocator for the
+//! parsed text, statements, located table references and expressions get their source span.
+class AstBuilder {
+public:
+	explicit AstBuilder(vector<AstNode> &nodes, SpanLocator *spans = nullptr);
+
+	void AddStatement(SQLStatement &stmt);
+
+private:
+	void AddStatement(idx_t parent, SQLStatement &stmt, const char *role);
+	idx_t AddNode(idx_t parent, const char *node_type, string kind, const char *role, string name = string(),
+	              string alias = string());
+	//! A table named by the statement itself rather than a table reference (INSERT INTO t, CREATE TABLE t), located
+	//! at the first occurrence of its unqualified name after keyword
+	void AddTarget(idx_t parent, const vector<string> &qualified_name, const char *keyword);
+
+	void AddSelect(idx_t parent, SelectStatement &select, const char *role, const string &name = string());
+	void AddQueryNode(idx_t parent, QueryNode &node, const char *role, const string &name = string());
+	void AddCTEs(idx_t parent, CommonTableExpressionMap &cte_map);
+	//! The assignments of an ON CONFLICT DO UPDATE or a MERGE ... UPDATE, and their WHERE
+	void AddUpdateSet(idx_t parent, UpdateSetInfo &set_info);
+	void AddTableRef(idx_t parent, TableRef &ref, const char *role);
+	//! Add an expression tree, widening [start, end) to the bytes it covers
+	void AddExpression(idx_t parent, const ParsedExpression &expr, const char *role, idx_t &start, idx_t &end);
+	void AddExpression(idx_t parent, const ParsedExpression &expr, const char *role);
+	template <class T>
+	void AddExpressions(idx_t parent, const vector<unique_ptr<T>> &exprs, const char *role) {
+		for (auto &expr : exprs) {
+			if (expr) {
+				AddExpression(parent, *expr, role);
+			}
+		}
+	}
+
+	vector<AstNode> &nodes;
+	SpanLocator *spans;
+	//! Location of the statement being added
+	idx_t stmt_location = 0;
+};
+
+//! Build the AST nodes of all statements of a parsed query
+void BuildAst(const vector<unique_ptr<SQLStatement>> &statements, vector<AstNode> &nodes,
+              SpanLocator *spans = nullptr);
+
+} // namespace duckdb
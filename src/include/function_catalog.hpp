@@ -0,0 +1,44 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+class ClientContext;
+
+enum class FunctionKind : uint8_t { UNKNOWN, SCALAR, AGGREGATE, TABLE, MACRO, TABLE_MACRO };
+
+//! The function_type reported for a kind: scalar, aggregate, table, macro, table_macro or unknown
+const char *FunctionKindName(FunctionKind kind);
+
+//! The function names of the catalogs attached to a context with their kind, for classifying the calls of parsed
+//! queries. Lookups are case-insensitive and do not allocate.
+class FunctionCatalog {
+public:
+	//! The functions of the catalogs of context. The table is kept in the context and rebuilt once any catalog
+	//! changed since it was built.
+	static shared_ptr<const FunctionCatalog> Get(ClientContext &context);
+
+	FunctionKind Lookup(const char *name, idx_t size) const;
+	FunctionKind Lookup(const string &name) const {
+		return Lookup(name.data(), name.size());
+	}
+
+private:
+	struct Entry {
+		string name;
+		FunctionKind kind;
+	};
+
+	//! Add a (lower-case) name, unless it was added before
+	void Add(const string &name, FunctionKind kind);
+	//! Slot of name, or of the empty slot it would go in
+	idx_t FindSlot(const char *name, idx_t size) const;
+	void Grow();
+
+	vector<Entry> entries;
+	//! Index + 1 into entries, 0 for an empty slot; kept at most half full
+	vector<uint32_t> slots;
+};
+
+} // namespace duckdb
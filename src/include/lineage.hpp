@@ -0,0 +1,37 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/parser/sql_statement.hpp"
+
+namespace duckdb {
+
+//! A column an output column is computed from
+struct LineageSource {
+	//! Empty if the table is not qualified with a schema
+	string schema;
+	//! The base table or table function of the column; empty if it cannot be told from the query alone, e.g. for an
+	//! unqualified column of a join of two base tables, or a column of a star over such a join
+	string table;
+	//! "*" for the columns of a base table selected with a star, which are not known without the catalog
+	string column;
+
+	bool operator==(const LineageSource &other) const {
+		return schema == other.schema && table == other.table && column == other.column;
+	}
+};
+
+//! An output column of a statement and the source columns it depends on, in the order they are first referenced
+struct ColumnLineage {
+	string name;
+	vector<LineageSource> sources;
+	//! A star over a base table: stands for all of its (unknown) columns, and its sources have the column "*"
+	bool star = false;
+};
+
+//! Resolve the output columns of a SELECT, INSERT ... SELECT or CREATE TABLE / VIEW ... AS statement to the columns
+//! of the base tables they depend on, following CTEs, subqueries (in FROM and in expressions), joins and set
+//! operations. Tables are only known by name: a column read through a star over a base table resolves to the column
+//! of that table, and a star at the top level is a single star column. Statements without a query have no columns.
+void ResolveLineage(SQLStatement &stmt, vector<ColumnLineage> &columns);
+
+} // namespace duckdb
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/parser/sql_statement.hpp"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace duckdb {
+
+//! The outcome of parsing one query text
+struct ParsedQuery {
+	bool success = false;
+	vector<unique_ptr<SQLStatement>> statements;
+	//! The parse error message (only set if !success)
+	string error;
+};
+
+//! Bounded, thread-safe LRU cache of parsed queries keyed by the query text.
+//! A single process-wide instance is shared by all poached scalar functions so
+//! that e.g. `is_valid_sql(q), parse_table_names(q)` parse each distinct q once.
+//! Cached statements are immutable and must only be read.
+//! The cache is split by query hash into shards with a lock and LRU list each,
+//! so that threads looking up different queries rarely wait for each other.
+//! Besides the number of queries, the total size of the cached query texts is
+//! bounded, which also bounds their statement trees as these grow with the text.
+class ParseCache {
+public:
+	static constexpr idx_t DEFAULT_CAPACITY = 1024;
+	//! Queries larger than this are parsed but never cached
+	static constexpr idx_t MAX_CACHED_QUERY_SIZE = 65536;
+	//! Maximum total size of the cached query texts, whatever the capacity
+	static constexpr idx_t MAX_CACHED_BYTES = 67108864;
+	static constexpr idx_t SHARD_COUNT = 16;
+
+	static ParseCache &Get();
+
+	//! Return the parse result of query, parsing it only on a cache miss
+	shared_ptr<const ParsedQuery> GetOrParse(const string_t &query);
+	//! Return the cached parse result of query, or nullptr if it is not cached (a miss is not counted)
+	shared_ptr<const ParsedQuery> Lookup(const string_t &query);
+	//! Parse query without consulting the cache
+	static shared_ptr<const ParsedQuery> Parse(const string &query);
+
+	//! Change the maximum number of cached queries, 0 disables the cache
+	void Resize(idx_t new_capacity);
+	void Clear();
+
+	idx_t Capacity() const {
+		return capacity.load();
+	}
+	idx_t Size();
+	idx_t Hits() const {
+		return hits.load();
+	}
+	idx_t Misses() const {
+		return misses.load();
+	}
+
+private:
+	ParseCache();
+
+	struct Entry {
+		hash_t hash;
+		string query;
+		shared_ptr<const ParsedQuery> result;
+	};
+	using entry_list_t = std::list<Entry>;
+
+	struct Shard {
+		std::mutex lock;
+		//! The share of the capacity of this shard
+		idx_t capacity = 0;
+		//! The share of MAX_CACHED_BYTES of this shard, and the size of its cached query texts
+		idx_t byte_capacity = 0;
+		idx_t bytes = 0;
+		//! Entries in recency order, most recently used first
+		entry_list_t entries;
+		std::unordered_multimap<hash_t, entry_list_t::iterator> index;
+
+		//! Find the entry for query and mark it as most recently used (lock must be held)
+		shared_ptr<const ParsedQuery> Lookup(hash_t hash, const string_t &query);
+		//! Evict least recently used entries until the shard fits its capacities (lock must be held)
+		void Evict();
+		//! Drop all entries (lock must be held)
+		void Clear();
+	};
+
+	Shard &GetShard(hash_t hash) {
+		// the low bits pick the bucket within a shard's index
+		return shards[(hash >> 32) % shard_count.load()];
+	}
+	//! Split capacity over the shards in use
+	void SetShardCapacities(idx_t new_capacity);
+
+	std::atomic<idx_t> capacity;
+	//! The number of shards in use, fewer than SHARD_COUNT for capacities below it
+	std::atomic<idx_t> shard_count;
+	Shard shards[SHARD_COUNT];
+	std::atomic<idx_t> hits;
+	std::atomic<idx_t> misses;
+};
+
+} // namespace duckdb
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/parser/parser.hpp"
+
+namespace duckdb {
+
+//! A Parser borrowed from a pool of this thread for one parse. Parsing row after row then reuses the parser objects,
+//! the capacity of their statement lists and a buffer for the text to parse, instead of building them for every
+//! row. The parser is reset when the lease ends: statements that were not moved out are dropped. Leases may nest,
+//! each one holds a parser of its own.
+class ParserLease {
+public:
+	ParserLease();
+	~ParserLease();
+	ParserLease(const ParserLease &) = delete;
+	ParserLease &operator=(const ParserLease &) = delete;
+
+	Parser &GetParser() {
+		return state->parser;
+	}
+	//! A buffer for the text to parse, empty but with the capacity of earlier uses
+	string &GetText() {
+		return state->text;
+	}
+
+	struct State {
+		Parser parser;
+		string text;
+	};
+
+private:
+	unique_ptr<State> state;
+};
+
+} // namespace duckdb
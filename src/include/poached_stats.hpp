@@ -0,0 +1,150 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/array.hpp"
+
+namespace duckdb {
+
+//! The functions counted in poached_stats(), in the order of its rows
+enum class PoachedFunction : uint8_t {
+	TOKENIZE_SQL,
+	PARSE_TOKENS,
+	SQL_KEYWORDS,
+	PARSE_KEYWORDS,
+	PARSE_STATEMENTS,
+	PARSE_SQL_FILE,
+	PARSE_SQL_FILE_TABLES,
+	PARSE_TABLES,
+	PARSE_FUNCTIONS,
+	PARSE_WHERE,
+	PARSE_COLUMNS,
+	PARSE_TOKENS_DELTA,
+	PARSE_TOKEN_LIST,
+	IS_VALID_SQL,
+	SQL_ERROR_MESSAGE,
+	SQL_ERROR_POSITION,
+	NUM_STATEMENTS,
+	IS_KEYWORD,
+	KEYWORD_CATEGORY,
+	PARSE_ANALYZE,
+	PARSE_AST,
+	SQL_STRIP_COMMENTS,
+	PARSE_NORMALIZE,
+	PARSE_FINGERPRINT,
+	PARSE_SQL_JSON,
+	SQL_PARSE_JSON,
+	PARSE_TABLE_NAMES,
+	PARSE_KEYWORD_NAMES,
+	PARSE_FUNCTION_NAMES,
+	PARSE_COLUMN_NAMES,
+	PARSE_LINEAGE,
+	PARSE_STATEMENT_TYPES,
+	PARSE_PARAMETERS,
+	NUM_PARAMETERS,
+	PARSE_SIGNATURE,
+	COUNT
+};
+static constexpr idx_t POACHED_FUNCTION_COUNT = static_cast<idx_t>(PoachedFunction::COUNT);
+
+//! The counters kept per function, in the order of the poached_stats() columns
+enum class PoachedStat : uint8_t {
+	//! Invocations of the function's execute callback (per chunk for scalar functions)
+	CALLS,
+	//! Rows produced
+	ROWS,
+	//! Bytes of query text taken in
+	BYTES_IN,
+	//! Time spent in the function, including its bind
+	TOTAL_TIME_NS,
+	//! Time spent in the parser, and in the tokenizer
+	PARSE_TIME_NS,
+	TOKENIZE_TIME_NS,
+	//! Exceptions caught and turned into an error result
+	EXCEPTIONS,
+	//! Parse cache lookups
+	CACHE_HITS,
+	CACHE_MISSES,
+	COUNT
+};
+static constexpr idx_t POACHED_STAT_COUNT = static_cast<idx_t>(PoachedStat::COUNT);
+
+using poached_counters_t = array<uint64_t, POACHED_STAT_COUNT>;
+
+//! Counters of the poached functions. Each thread counts into its own block, which only it writes, so counting is a
+//! plain relaxed store without locks or contended cache lines; blocks are summed when the stats are read. Counts are
+//! attributed to the function that is running on the thread, see PoachedStatsScope. Defining
+//! POACHED_DISABLE_STATS compiles all counting out.
+class PoachedStats {
+public:
+	static const char *FunctionName(PoachedFunction function);
+	static const char *StatName(PoachedStat stat);
+
+#ifdef POACHED_DISABLE_STATS
+	static constexpr bool ENABLED = false;
+
+	static void Add(PoachedStat stat, uint64_t value = 1) {
+	}
+	static uint64_t Now() {
+		return 0;
+	}
+#else
+	static constexpr bool ENABLED = true;
+
+	//! Add to a counter of the function running on this thread, a no-op outside of one
+	static void Add(PoachedStat stat, uint64_t value = 1);
+	//! Monotonic time in nanoseconds
+	static uint64_t Now();
+#endif
+
+	//! The counters of all functions since the last Reset
+	static vector<poached_counters_t> Snapshot();
+	static void Reset();
+
+private:
+	friend class PoachedStatsScope;
+
+	//! Make function the one running on this thread, returns the previous one
+	static PoachedFunction Enter(PoachedFunction function);
+	static void Exit(PoachedFunction previous, uint64_t start);
+};
+
+//! Attributes the counts of its lifetime on this thread to a function and adds its duration to TOTAL_TIME_NS
+class PoachedStatsScope {
+public:
+#ifdef POACHED_DISABLE_STATS
+	explicit PoachedStatsScope(PoachedFunction function) {
+	}
+#else
+	explicit PoachedStatsScope(PoachedFunction function)
+	    : previous(PoachedStats::Enter(function)), start(PoachedStats::Now()) {
+	}
+	~PoachedStatsScope() {
+		PoachedStats::Exit(previous, start);
+	}
+
+private:
+	PoachedFunction previous;
+	uint64_t start;
+#endif
+};
+
+//! Adds the duration of its lifetime to a time counter of the running function
+class PoachedStatsTimer {
+public:
+#ifdef POACHED_DISABLE_STATS
+	explicit PoachedStatsTimer(PoachedStat stat) {
+	}
+#else
+	explicit PoachedStatsTimer(PoachedStat stat) : stat(stat), start(PoachedStats::Now()) {
+	}
+	~PoachedStatsTimer() {
+		PoachedStats::Add(stat, PoachedStats::Now() - start);
+	}
+
+private:
+	PoachedStat stat;
+	uint64_t start;
+#endif
+};
+
+} // namespace duckdb
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/parser/sql_statement.hpp"
+#include "source_span.hpp"
+#include "function_catalog.hpp"
+#include "duckdb/common/unordered_set.hpp"
+
+namespace duckdb {
+
+class ParsedExpression;
+class QueryNode;
+class SelectStatement;
+class TableRef;
+class CommonTableExpressionMap;
+class UpdateSetInfo;
+
+struct ExtractedTable {
+	string schema;
+	string table;
+	string context; // "FROM", "JOIN", "INSERT", etc.
+	SourceSpan span;
+};
+
+struct FunctionRef {
+	string name;
+	string type; // "operator", "window" or the FunctionKindName of the function
+	SourceSpan span;
+};
+
+struct ColumnReference {
+	//! The table (or alias) the column is qualified with, empty if unqualified
+	string table;
+	string column;
+	SourceSpan span;
+};
+
+struct WhereCondition {
+	string column_name;
+	string op;
+	string value;
+	SourceSpan span;
+};
+
+//! An occurrence of a prepared statement parameter ($1, ? or $name)
+struct ParameterRef {
+	//! The identifier of the parameter in the statement's named_param_map: its number, or its name for $name
+	string name;
+	//! The column the parameter binds a value of: compared with, assigned in an UPDATE or inserted into by an
+	//! INSERT ... VALUES with a column list; empty if there is none
+	string column;
+	//! Where the parameter starts in the parsed text
+	optional_idx location;
+};
+
+//! The summaries of a query collected by QueryAnalyzer, in the order the walk first meets them
+struct QueryAnalysis {
+	vector<ExtractedTable> tables;
+	vector<FunctionRef> functions;
+	vector<ColumnReference> columns;
+	vector<WhereCondition> conditions;
+	vector<ParameterRef> parameters;
+};
+
+//! Which summaries a QueryAnalyzer fills; the tree is walked once regardless
+enum class AnalysisTarget : uint8_t {
+	TABLES = 1 << 0,
+	FUNCTIONS = 1 << 1,
+	COLUMNS = 1 << 2,
+	CONDITIONS = 1 << 3,
+	PARAMETERS = 1 << 4,
+	//! The summaries of parse_analyze
+	ALL = TABLES | FUNCTIONS | COLUMNS | CONDITIONS
+};
+
+//! The values a string column is restricted to by the equality and IN filters pushed down into a scan; without a
+//! restriction every value is accepted
+class ValueFilter {
+public:
+	bool IsRestricted() const {
+		return restricted;
+	}
+	bool Accepts(const string &value) const {
+		return !restricted || values.find(value) != values.end();
+	}
+	//! Accept only the values that are accepted already and in accepted
+	void Restrict(const unordered_set<string> &accepted);
+
+private:
+	bool restricted = false;
+	unordered_set<string> values;
+};
+
+//! Receives names found by a QueryAnalyzer as references into the AST, for callers that only need the names and
+//! can store them without an intermediate copy
+class NameSink {
+public:
+	virtual ~NameSink() = default;
+	virtual void AddName(const string &name) = 0;
+	//! The names of tables with their schema (empty if unqualified); AddName of the table name unless the sink
+	//! tells tables of different schemas apart
+	virtual void AddTableName(const string &schema, const string &name) {
+		AddName(name);
+	}
+	//! The names of functions; AddName unless the sink tells them apart from table names
+	virtual void AddFunctionName(const string &name) {
+		AddName(name);
+	}
+};
+
+//! Walks statement trees once and records table references, function calls, column references, WHERE conditions and
+//! parameters. Descends into set operations, CTEs, joins, PIVOTs, subqueries (in FROM and in expressions) and all
+//! clauses of SELECT, INSERT, UPDATE, DELETE, MERGE, COPY and CREATE TABLE / VIEW ... AS, and into the statements of
+//! EXPLAIN and PREPARE; records the targets of CREATE INDEX, DROP and ALTER of tables and views and of VACUUM and
+//! ANALYZE, and the expressions of EXECUTE, CALL and SET. With a SpanLocator for the parsed text, the source span of
+//! everything recorded is filled in as well. With a NameSink, the names of the targeted tables and functions are passed
+//! to it instead of being recorded in the result. Function calls are classified against a FunctionCatalog if given,
+//! else by a list of common aggregates.
+class QueryAnalyzer {
+public:
+	explicit QueryAnalyzer(QueryAnalysis &result, AnalysisTarget targets = AnalysisTarget::ALL,
+	                       SpanLocator *spans = nullptr, NameSink *names = nullptr,
+	                       const FunctionCatalog *functions = nullptr);
+
+	void VisitStatement(SQLStatement &stmt);
+	//! Whether to print the column name and value operands of conditions, which is the costly part of recording them;
+	//! both are printed by default
+	void SetConditionOperands(bool column_name, bool value) {
+		condition_column_names = column_name;
+		condition_values = value;
+	}
+	//! Only record tables referenced in one of the accepted contexts, and functions of one of the accepted types. When
+	//! only tables are collected and no context of a query body (FROM, JOIN, TABLE_FUNCTION) is accepted, query
+	//! bodies and expressions are not walked at all. The filters must outlive the analyzer.
+	void SetTableContexts(const ValueFilter &contexts);
+	void SetFunctionTypes(const ValueFilter &types);
+
+private:
+	bool Collects(AnalysisTarget target) const;
+	void AddTable(const string &schema, const string &table, const string &context, SourceSpan span = SourceSpan());
+	//! Span of a statement target, which is not located in the AST: its name after keyword
+	SourceSpan TargetSpan(const char *keyword, const string &name);
+
+	void VisitSelect(SelectStatement &select);
+	void VisitQueryNode(QueryNode &node);
+	void VisitCTEs(CommonTableExpressionMap &cte_map);
+	void VisitTableRef(TableRef &ref, const string &context);
+	void VisitExpression(const ParsedExpression &expr);
+	void VisitUpdateSet(UpdateSetInfo &set_info);
+	void AddFunction(const ParsedExpression &expr, const string &name, const char *type);
+	void AddParameter(const ParsedExpression &expr);
+	const char *FunctionType(const string &name) const;
+	//! Visit a WHERE clause, also recording its (AND/OR-connected) comparisons as conditions
+	void VisitWhereClause(const ParsedExpression &expr);
+	void ExtractConditions(const ParsedExpression &expr);
+
+	QueryAnalysis &result;
+	AnalysisTarget targets;
+	SpanLocator *spans;
+	NameSink *names;
+	const FunctionCatalog *functions;
+	bool condition_column_names = true;
+	bool condition_values = true;
+	const ValueFilter *table_contexts = nullptr;
+	const ValueFilter *function_types = nullptr;
+	//! Whether nothing to record can be found in query bodies and expressions
+	bool skip_bodies = false;
+	//! Location of the statement being visited
+	idx_t stmt_location = 0;
+	//! The column a parameter visited next binds a value of, nullptr if none
+	const string *parameter_column = nullptr;
+	//! The VALUES list of the INSERT being visited, with the columns it inserts into
+	const TableRef *insert_values = nullptr;
+	const vector<string> *insert_columns = nullptr;
+};
+
+//! The output name of a SELECT list expression: its alias, column or function name as a reference into the AST, or
+//! else its string form, built in scratch
+const string &GetExpressionName(const ParsedExpression &expr, string &scratch);
+
+//! Analyze all statements of a parsed query with a single walk
+void AnalyzeStatements(const vector<unique_ptr<SQLStatement>> &statements, QueryAnalysis &result,
+                       AnalysisTarget targets = AnalysisTarget::ALL, SpanLocator *spans = nullptr,
+                       const FunctionCatalog *functions = nullptr);
+//! Pass the names of all tables or functions (per targets) of a parsed query to names, in walk order
+void AnalyzeNames(const vector<unique_ptr<SQLStatement>> &statements, AnalysisTarget targets, NameSink &names);
+
+} // namespace duckdb
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+//! The outcome of checking a query against the SQL grammar
+struct QueryValidation {
+	bool success = false;
+	//! Number of statements in the query (only set if success)
+	idx_t statement_count = 0;
+	//! The error message, formatted like the ParserException Parser::ParseQuery throws
+	string error;
+	//! Byte offset of the syntax error in the query, if known
+	optional_idx error_location;
+};
+
+//! Check a query against the grammar without throwing a DuckDB exception per invalid row. Without transform, the raw
+//! parse tree is not transformed into SQLStatements: of the queries only the transformer rejects, those mixing
+//! parameter styles are caught by a token scan, others are reported as valid. With transform, the parse tree is
+//! transformed too (and discarded), so the result and error message are those of Parser::ParseQuery.
+QueryValidation ValidateQuery(const string &query, bool transform = false);
+
+} // namespace duckdb
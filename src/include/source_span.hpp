@@ -0,0 +1,97 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/parser/simplified_token.hpp"
+
+namespace duckdb {
+
+class ParsedExpression;
+
+//! Byte range [start_byte, end_byte) of a construct in the query text, with the 1-based line and byte column of its
+//! start. A span with line 0 is unknown.
+struct SourceSpan {
+	idx_t start_byte = 0;
+	idx_t end_byte = 0;
+	idx_t line = 0;
+	idx_t column = 0;
+
+	bool IsValid() const {
+		return line != 0;
+	}
+};
+
+//! The position after the string literal or quoted identifier opened at pos (doubled quotes are escapes), or size if
+//! unterminated
+idx_t SkipStringLiteral(const char *data, idx_t pos, idx_t size);
+//! The position after the "*/" closing a block comment whose body starts at pos, or size if unterminated
+idx_t FindBlockCommentEnd(const char *data, idx_t pos, idx_t size);
+//! The position of the first token at or after pos: past whitespace and comments
+idx_t SkipSpaceAndComments(const char *data, idx_t pos, idx_t size);
+//! The end of the text of the token starting at start, where next is the start of the following token (or the end of
+//! the text). Parser::Tokenize returns no comment tokens, so the bytes in between can hold comments next to whitespace;
+//! the token runs to the end of its last word, literal or operator before next.
+idx_t TokenTextEnd(const char *data, idx_t start, idx_t next);
+
+//! Line starts of a text, to turn byte offsets into line and column numbers
+class LineIndex {
+public:
+	explicit LineIndex(const string &text);
+
+	//! Fill in line and column of span from its start_byte
+	void Locate(SourceSpan &span) const;
+
+private:
+	vector<idx_t> line_starts;
+};
+
+//! Maps the query_location of parsed constructs to their source spans. AST locations only mark where a construct
+//! starts, the end is found with the tokenizer: a call or parenthesized construct ends at its closing parenthesis,
+//! a (qualified) name at its last part. The text is tokenized on first use.
+class SpanLocator {
+public:
+	explicit SpanLocator(const string &query);
+
+	//! Set the offset of the parsed text in the query, for statements parsed from a part of it
+	void SetBase(idx_t new_base) {
+		base = new_base;
+	}
+
+	//! The byte at a location of the parsed text, '\0' past its end
+	char At(idx_t location) const {
+		auto pos = base + location;
+		return pos < query.size() ? query[pos] : '\0';
+	}
+	//! Span of the bytes [start, end), trailing whitespace excluded
+	SourceSpan Span(idx_t start, idx_t end);
+	//! Span of the length bytes at location, surrounding whitespace excluded
+	SourceSpan RangeSpan(idx_t location, idx_t length);
+	//! Span of the construct starting at location
+	SourceSpan ConstructSpan(idx_t location);
+	//! Span of an expression, from the first to the end of the last located construct in its tree
+	SourceSpan ExpressionSpan(const ParsedExpression &expr);
+	//! Span of a name that is not located in the AST (e.g. an INSERT target): its first occurrence after the first
+	//! keyword token after from, including any qualification
+	SourceSpan FindName(idx_t from, const char *keyword, const string &name);
+	//! Extend span over a following [AS] alias
+	void ExtendOverAlias(SourceSpan &span, const string &alias);
+
+private:
+	void InitializeTokens();
+	//! Index of the last token starting at or before pos
+	idx_t TokenAt(idx_t pos) const;
+	idx_t TokenEnd(idx_t token_idx) const;
+	bool TokenIs(idx_t token_idx, char c) const;
+	bool TokenEquals(idx_t token_idx, const string &text) const;
+	//! Index of the last token of the construct starting at token_idx
+	idx_t ConstructEndToken(idx_t token_idx) const;
+	void ExpressionRange(const ParsedExpression &expr, idx_t &start, idx_t &end);
+
+	const string &query;
+	//! Offset added to AST locations
+	idx_t base = 0;
+	bool tokenized = false;
+	vector<SimplifiedToken> tokens;
+	unique_ptr<LineIndex> lines;
+};
+
+} // namespace duckdb
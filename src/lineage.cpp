@@ -0,0 +1,512 @@
+#include "lineage.hpp"
+#include "query_analysis.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/query_node.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/query_node/set_operation_node.hpp"
+#include "duckdb/parser/query_node/recursive_cte_node.hpp"
+#include "duckdb/parser/query_node/cte_node.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/statement/insert_statement.hpp"
+#include "duckdb/parser/statement/create_statement.hpp"
+#include "duckdb/parser/parsed_data/create_table_info.hpp"
+#include "duckdb/parser/parsed_data/create_view_info.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+#include "duckdb/parser/tableref/table_function_ref.hpp"
+#include "duckdb/parser/tableref/expressionlistref.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/expression/star_expression.hpp"
+#include "duckdb/parser/expression/subquery_expression.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+// A query node is resolved to its relation, the lineage of its output columns, within a scope of the CTEs and FROM
+// bindings it can see. A base table is a relation of a single star column, so that any column read from it resolves
+// to the column of that table, and a star over it passes that star column on. Columns that a scope does not bind are
+// looked up in the enclosing scopes, for correlated subqueries.
+
+namespace {
+
+using LineageRelation = vector<ColumnLineage>;
+
+struct LineageBinding {
+	string name;
+	shared_ptr<const LineageRelation> relation;
+};
+
+struct LineageScope {
+	explicit LineageScope(const LineageScope *parent) : parent(parent) {
+	}
+
+	const LineageScope *parent;
+	case_insensitive_map_t<shared_ptr<const LineageRelation>> ctes;
+	vector<LineageBinding> bindings;
+	//! The aliased columns of the SELECT list resolved so far, which later expressions of the list can refer to
+	const LineageRelation *select_aliases = nullptr;
+
+	//! The CTE of a name visible in the scope, nullptr if there is none
+	shared_ptr<const LineageRelation> FindCTE(const string &name) const {
+		for (auto scope = this; scope; scope = scope->parent) {
+			auto entry = scope->ctes.find(name);
+			if (entry != scope->ctes.end()) {
+				return entry->second;
+			}
+		}
+		return nullptr;
+	}
+
+	//! The binding of a table name or alias in the scope or an enclosing one, nullptr if there is none
+	const LineageBinding *FindBinding(const string &name) const {
+		for (auto scope = this; scope; scope = scope->parent) {
+			for (auto &binding : scope->bindings) {
+				if (StringUtil::CIEquals(binding.name, name)) {
+					return &binding;
+				}
+			}
+		}
+		return nullptr;
+	}
+};
+
+} // namespace
+
+static LineageRelation ResolveSelect(SelectStatement &select, const LineageScope *parent);
+static LineageRelation ResolveQueryNode(QueryNode &node, const LineageScope *parent);
+static void AddExpressionSources(const LineageScope &scope, const ParsedExpression &expr,
+                                 vector<LineageSource> &sources);
+
+static void AddSource(vector<LineageSource> &sources, const LineageSource &source) {
+	if (std::find(sources.begin(), sources.end(), source) == sources.end()) {
+		sources.push_back(source);
+	}
+}
+
+static void AddSources(vector<LineageSource> &sources, const vector<LineageSource> &added) {
+	for (auto &source : added) {
+		AddSource(sources, source);
+	}
+}
+
+static LineageRelation BaseTableRelation(const string &schema, const string &table) {
+	ColumnLineage column;
+	column.name = "*";
+	column.sources.push_back(LineageSource {schema, table, "*"});
+	column.star = true;
+	return LineageRelation {std::move(column)};
+}
+
+// Rename the columns of a relation to the column aliases of a CTE or table reference. The position of the columns
+// after a star is not known, so only the columns before the first one are renamed.
+static void ApplyAliases(LineageRelation &relation, const vector<string> &aliases) {
+	for (idx_t i = 0; i < relation.size() && i < aliases.size(); i++) {
+		if (relation[i].star) {
+			break;
+		}
+		relation[i].name = aliases[i];
+	}
+}
+
+// Add the sources of a column of a relation: those of the column of that name, or else the column of that name of
+// its star; returns whether the relation has the column. A relation with stars over different tables side by side
+// (a star over a join) has the column in one of them, which cannot be told, while the sources of a single star (of a
+// set operation) all provide it.
+static bool AddRelationColumn(const LineageRelation &relation, const string &name, vector<LineageSource> &sources) {
+	for (auto &column : relation) {
+		if (!column.star && StringUtil::CIEquals(column.name, name)) {
+			AddSources(sources, column.sources);
+			return true;
+		}
+	}
+	const ColumnLineage *star = nullptr;
+	for (auto &column : relation) {
+		if (!column.star) {
+			continue;
+		}
+		if (star && star->sources != column.sources) {
+			AddSource(sources, LineageSource {string(), string(), name});
+			return true;
+		}
+		star = &column;
+	}
+	if (!star) {
+		return false;
+	}
+	for (auto &source : star->sources) {
+		AddSource(sources, LineageSource {source.schema, source.table, name});
+	}
+	return true;
+}
+
+static bool HasStar(const LineageRelation &relation) {
+	for (auto &column : relation) {
+		if (column.star) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Add the sources of an unqualified column. A column a binding has by name wins over an earlier alias of the SELECT
+// list, which wins over the unknown columns behind stars; if more than one binding has such unknown columns, the
+// column's table cannot be told.
+static void AddUnqualifiedColumn(const LineageScope &scope, const string &name, vector<LineageSource> &sources) {
+	for (auto current = &scope; current; current = current->parent) {
+		for (auto &binding : current->bindings) {
+			for (auto &column : *binding.relation) {
+				if (!column.star && StringUtil::CIEquals(column.name, name)) {
+					AddSources(sources, column.sources);
+					return;
+				}
+			}
+		}
+		if (current->select_aliases) {
+			for (auto &column : *current->select_aliases) {
+				if (StringUtil::CIEquals(column.name, name)) {
+					AddSources(sources, column.sources);
+					return;
+				}
+			}
+		}
+		const LineageBinding *star_binding = nullptr;
+		idx_t star_bindings = 0;
+		for (auto &binding : current->bindings) {
+			if (HasStar(*binding.relation)) {
+				star_binding = &binding;
+				star_bindings++;
+			}
+		}
+		if (star_bindings == 1) {
+			AddRelationColumn(*star_binding->relation, name, sources);
+			return;
+		}
+		if (star_bindings > 1) {
+			break;
+		}
+	}
+	AddSource(sources, LineageSource {string(), string(), name});
+}
+
+// Add the sources of a column reference: col, table.col or schema.table.col, or a struct field (col.field) of a
+// column
+static void AddColumnRefSources(const LineageScope &scope, const ColumnRefExpression &col,
+                                vector<LineageSource> &sources) {
+	auto &names = col.column_names;
+	if (names.size() > 1) {
+		auto binding = scope.FindBinding(names[names.size() - 2]);
+		if (binding && AddRelationColumn(*binding->relation, names.back(), sources)) {
+			return;
+		}
+		if (names.size() > 2) {
+			// table.col.field
+			binding = scope.FindBinding(names[0]);
+			if (binding && AddRelationColumn(*binding->relation, names[1], sources)) {
+				return;
+			}
+		}
+	}
+	AddUnqualifiedColumn(scope, names[0], sources);
+}
+
+static bool IsExcluded(const StarExpression &star, const string &name) {
+	for (auto &excluded : star.exclude_list) {
+		if (StringUtil::CIEquals(excluded.column, name)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Expand a star (*, table.* or COLUMNS(...)) over the bindings of the scope, applying its EXCLUDE, REPLACE and RENAME
+// lists to the known columns. COLUMNS(...) selects a subset of the columns that is only known once bound, so it is
+// taken to select all of them.
+static void ExpandStar(const LineageScope &scope, const StarExpression &star, LineageRelation &result) {
+	for (auto &binding : scope.bindings) {
+		if (!star.relation_name.empty() && !StringUtil::CIEquals(binding.name, star.relation_name)) {
+			continue;
+		}
+		for (auto &column : *binding.relation) {
+			if (column.star) {
+				result.push_back(column);
+				continue;
+			}
+			if (IsExcluded(star, column.name)) {
+				continue;
+			}
+			auto expanded = column;
+			auto replace = star.replace_list.find(column.name);
+			if (replace != star.replace_list.end()) {
+				expanded.sources.clear();
+				AddExpressionSources(scope, *replace->second, expanded.sources);
+			}
+			for (auto &rename : star.rename_list) {
+				if (StringUtil::CIEquals(rename.first.column, column.name)) {
+					expanded.name = rename.second;
+				}
+			}
+			result.push_back(std::move(expanded));
+		}
+	}
+}
+
+static void AddExpressionSources(const LineageScope &scope, const ParsedExpression &expr,
+                                 vector<LineageSource> &sources) {
+	switch (expr.GetExpressionClass()) {
+	case ExpressionClass::COLUMN_REF:
+		AddColumnRefSources(scope, expr.Cast<ColumnRefExpression>(), sources);
+		return;
+	case ExpressionClass::STAR: {
+		// a star within an expression, e.g. struct_pack(*) or max(COLUMNS(*))
+		LineageRelation expanded;
+		ExpandStar(scope, expr.Cast<StarExpression>(), expanded);
+		for (auto &column : expanded) {
+			AddSources(sources, column.sources);
+		}
+		return;
+	}
+	case ExpressionClass::SUBQUERY: {
+		auto &subquery = expr.Cast<SubqueryExpression>();
+		// the value of an EXISTS does not come from the columns of its subquery
+		if (subquery.subquery && subquery.subquery_type != SubqueryType::EXISTS &&
+		    subquery.subquery_type != SubqueryType::NOT_EXISTS) {
+			for (auto &column : ResolveSelect(*subquery.subquery, &scope)) {
+				AddSources(sources, column.sources);
+			}
+		}
+		break;
+	}
+	default:
+		break;
+	}
+	ParsedExpressionIterator::EnumerateChildren(
+	    expr, [&](const ParsedExpression &child) { AddExpressionSources(scope, child, sources); });
+}
+
+// Bind the relations of a table reference (and of the sides of a join) in the scope
+static void AddTableRef(LineageScope &scope, TableRef &ref) {
+	shared_ptr<const LineageRelation> relation;
+	string name = ref.alias;
+	switch (ref.type) {
+	case TableReferenceType::BASE_TABLE: {
+		auto &base = ref.Cast<BaseTableRef>();
+		if (name.empty()) {
+			name = base.table_name;
+		}
+		if (base.schema_name.empty()) {
+			relation = scope.FindCTE(base.table_name);
+		}
+		if (!relation) {
+			// the column aliases of a base table rename columns that are not known, they are left out
+			scope.bindings.push_back(LineageBinding {
+			    name, make_shared_ptr<LineageRelation>(BaseTableRelation(base.schema_name, base.table_name))});
+			return;
+		}
+		break;
+	}
+	case TableReferenceType::JOIN: {
+		auto &join = ref.Cast<JoinRef>();
+		if (join.left) {
+			AddTableRef(scope, *join.left);
+		}
+		if (join.right) {
+			AddTableRef(scope, *join.right);
+		}
+		return;
+	}
+	case TableReferenceType::SUBQUERY: {
+		auto &subquery = ref.Cast<SubqueryRef>();
+		if (!subquery.subquery) {
+			return;
+		}
+		relation = make_shared_ptr<LineageRelation>(ResolveSelect(*subquery.subquery, &scope));
+		break;
+	}
+	case TableReferenceType::TABLE_FUNCTION: {
+		auto &func = ref.Cast<TableFunctionRef>();
+		if (!func.function || func.function->type != ExpressionType::FUNCTION) {
+			return;
+		}
+		auto &fn = func.function->Cast<FunctionExpression>();
+		if (name.empty()) {
+			name = fn.function_name;
+		}
+		scope.bindings.push_back(
+		    LineageBinding {name, make_shared_ptr<LineageRelation>(BaseTableRelation(fn.schema, fn.function_name))});
+		return;
+	}
+	case TableReferenceType::EXPRESSION_LIST: {
+		auto &values = ref.Cast<ExpressionListRef>();
+		LineageRelation columns;
+		for (auto &row : values.values) {
+			for (idx_t i = 0; i < row.size(); i++) {
+				if (i >= columns.size()) {
+					ColumnLineage column;
+					column.name =
+					    i < values.expected_names.size() ? values.expected_names[i] : "col" + std::to_string(i);
+					columns.push_back(std::move(column));
+				}
+				AddExpressionSources(scope, *row[i], columns[i].sources);
+			}
+		}
+		relation = make_shared_ptr<LineageRelation>(std::move(columns));
+		break;
+	}
+	default:
+		return;
+	}
+	if (!ref.column_name_alias.empty()) {
+		auto renamed = make_shared_ptr<LineageRelation>(*relation);
+		ApplyAliases(*renamed, ref.column_name_alias);
+		relation = std::move(renamed);
+	}
+	scope.bindings.push_back(LineageBinding {std::move(name), std::move(relation)});
+}
+
+// Resolve the CTEs of a WITH clause into the scope; each can refer to the ones before it
+static void AddCTEs(LineageScope &scope, CommonTableExpressionMap &cte_map) {
+	for (auto &cte : cte_map.map) {
+		if (!cte.second || !cte.second->query) {
+			continue;
+		}
+		auto relation = ResolveSelect(*cte.second->query, &scope);
+		ApplyAliases(relation, cte.second->aliases);
+		scope.ctes[cte.first] = make_shared_ptr<LineageRelation>(std::move(relation));
+	}
+}
+
+// Merge the columns of a set operation side into the result, by position
+static void MergeColumns(LineageRelation &result, LineageRelation &&side) {
+	if (result.empty()) {
+		result = std::move(side);
+		return;
+	}
+	for (idx_t i = 0; i < result.size() && i < side.size(); i++) {
+		AddSources(result[i].sources, side[i].sources);
+	}
+}
+
+static LineageRelation ResolveQueryNode(QueryNode &node, const LineageScope *parent) {
+	LineageScope scope(parent);
+	AddCTEs(scope, node.cte_map);
+	LineageRelation result;
+	switch (node.type) {
+	case QueryNodeType::SELECT_NODE: {
+		auto &select = node.Cast<SelectNode>();
+		if (select.from_table) {
+			AddTableRef(scope, *select.from_table);
+		}
+		string scratch;
+		LineageRelation aliases;
+		scope.select_aliases = &aliases;
+		for (auto &expr : select.select_list) {
+			if (expr->GetExpressionClass() == ExpressionClass::STAR && expr->alias.empty()) {
+				ExpandStar(scope, expr->Cast<StarExpression>(), result);
+				continue;
+			}
+			ColumnLineage column;
+			column.name = GetExpressionName(*expr, scratch);
+			AddExpressionSources(scope, *expr, column.sources);
+			if (!expr->alias.empty()) {
+				aliases.push_back(column);
+			}
+			result.push_back(std::move(column));
+		}
+		scope.select_aliases = nullptr;
+		break;
+	}
+	case QueryNodeType::SET_OPERATION_NODE: {
+		auto &setop = node.Cast<SetOperationNode>();
+		for (auto &child : setop.children) {
+			MergeColumns(result, ResolveQueryNode(*child, &scope));
+		}
+		break;
+	}
+	case QueryNodeType::RECURSIVE_CTE_NODE: {
+		auto &cte = node.Cast<RecursiveCTENode>();
+		if (cte.left) {
+			result = ResolveQueryNode(*cte.left, &scope);
+			ApplyAliases(result, cte.aliases);
+		}
+		if (cte.right) {
+			// the recursive part reads the CTE itself, whose columns are those of the non-recursive part
+			LineageScope recursive(&scope);
+			recursive.ctes[cte.ctename] = make_shared_ptr<LineageRelation>(result);
+			MergeColumns(result, ResolveQueryNode(*cte.right, &recursive));
+		}
+		break;
+	}
+	case QueryNodeType::CTE_NODE: {
+		auto &cte = node.Cast<CTENode>();
+		if (cte.query) {
+			auto relation = ResolveQueryNode(*cte.query, &scope);
+			ApplyAliases(relation, cte.aliases);
+			scope.ctes[cte.ctename] = make_shared_ptr<LineageRelation>(std::move(relation));
+		}
+		if (cte.child) {
+			result = ResolveQueryNode(*cte.child, &scope);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+	return result;
+}
+
+static LineageRelation ResolveSelect(SelectStatement &select, const LineageScope *parent) {
+	if (!select.node) {
+		return LineageRelation();
+	}
+	return ResolveQueryNode(*select.node, parent);
+}
+
+void ResolveLineage(SQLStatement &stmt, vector<ColumnLineage> &columns) {
+	LineageRelation relation;
+	switch (stmt.type) {
+	case StatementType::SELECT_STATEMENT:
+		relation = ResolveSelect(stmt.Cast<SelectStatement>(), nullptr);
+		break;
+	case StatementType::INSERT_STATEMENT: {
+		auto &insert = stmt.Cast<InsertStatement>();
+		if (!insert.select_statement) {
+			return;
+		}
+		LineageScope scope(nullptr);
+		AddCTEs(scope, insert.cte_map);
+		relation = ResolveSelect(*insert.select_statement, &scope);
+		// the output columns are the columns inserted into
+		ApplyAliases(relation, insert.columns);
+		break;
+	}
+	case StatementType::CREATE_STATEMENT: {
+		auto &create = stmt.Cast<CreateStatement>();
+		if (!create.info) {
+			return;
+		}
+		if (create.info->type == CatalogType::TABLE_ENTRY) {
+			auto &info = create.info->Cast<CreateTableInfo>();
+			if (info.query) {
+				relation = ResolveSelect(*info.query, nullptr);
+			}
+		} else if (create.info->type == CatalogType::VIEW_ENTRY) {
+			auto &info = create.info->Cast<CreateViewInfo>();
+			if (info.query) {
+				relation = ResolveSelect(*info.query, nullptr);
+				ApplyAliases(relation, info.aliases);
+			}
+		}
+		break;
+	}
+	default:
+		return;
+	}
+	for (auto &column : relation) {
+		columns.push_back(std::move(column));
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,164 @@
+#include "parse_cache.hpp"
+#include "poached_stats.hpp"
+#include "parser_pool.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/hash.hpp"
+
+namespace duckdb {
+
+ParseCache::ParseCache() : capacity(DEFAULT_CAPACITY), shard_count(SHARD_COUNT), hits(0), misses(0) {
+	SetShardCapacities(DEFAULT_CAPACITY);
+}
+
+ParseCache &ParseCache::Get() {
+	static ParseCache cache;
+	return cache;
+}
+
+shared_ptr<const ParsedQuery> ParseCache::Parse(const string &query) {
+	auto result = make_shared_ptr<ParsedQuery>();
+	try {
+		ParserLease lease;
+		auto &parser = lease.GetParser();
+		{
+			PoachedStatsTimer timer(PoachedStat::PARSE_TIME_NS);
+			parser.ParseQuery(query);
+		}
+		result->statements = std::move(parser.statements);
+		result->success = true;
+	} catch (const std::exception &e) {
+		PoachedStats::Add(PoachedStat::EXCEPTIONS);
+		result->error = e.what();
+	}
+	return std::move(result);
+}
+
+shared_ptr<const ParsedQuery> ParseCache::Shard::Lookup(hash_t hash, const string_t &query) {
+	auto range = index.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it) {
+		auto &entry = *it->second;
+		if (entry.query.size() == query.GetSize() &&
+		    memcmp(entry.query.data(), query.GetData(), query.GetSize()) == 0) {
+			// move the entry to the front of the LRU list
+			entries.splice(entries.begin(), entries, it->second);
+			return entry.result;
+		}
+	}
+	return nullptr;
+}
+
+shared_ptr<const ParsedQuery> ParseCache::Lookup(const string_t &query) {
+	if (capacity.load() == 0 || query.GetSize() > MAX_CACHED_QUERY_SIZE) {
+		return nullptr;
+	}
+	auto hash = Hash(query.GetData(), query.GetSize());
+	auto &shard = GetShard(hash);
+	std::lock_guard<std::mutex> guard(shard.lock);
+	auto result = shard.Lookup(hash, query);
+	if (result) {
+		hits++;
+		PoachedStats::Add(PoachedStat::CACHE_HITS);
+	}
+	return result;
+}
+
+shared_ptr<const ParsedQuery> ParseCache::GetOrParse(const string_t &query) {
+	if (capacity.load() == 0 || query.GetSize() > MAX_CACHED_QUERY_SIZE) {
+		return Parse(query.GetString());
+	}
+	auto hash = Hash(query.GetData(), query.GetSize());
+	auto &shard = GetShard(hash);
+	{
+		std::lock_guard<std::mutex> guard(shard.lock);
+		auto result = shard.Lookup(hash, query);
+		if (result) {
+			hits++;
+			PoachedStats::Add(PoachedStat::CACHE_HITS);
+			return result;
+		}
+	}
+	misses++;
+	PoachedStats::Add(PoachedStat::CACHE_MISSES);
+
+	// parse outside of the lock - concurrent misses on the same query may parse it twice
+	auto result = Parse(query.GetString());
+
+	std::lock_guard<std::mutex> guard(shard.lock);
+	auto existing = shard.Lookup(hash, query);
+	if (existing) {
+		return existing;
+	}
+	shard.entries.push_front(Entry {hash, query.GetString(), result});
+	shard.index.emplace(hash, shard.entries.begin());
+	shard.bytes += query.GetSize();
+	shard.Evict();
+	return result;
+}
+
+void ParseCache::Shard::Evict() {
+	while (entries.size() > capacity || bytes > byte_capacity) {
+		auto last = std::prev(entries.end());
+		auto range = index.equal_range(last->hash);
+		for (auto it = range.first; it != range.second; ++it) {
+			if (it->second == last) {
+				index.erase(it);
+				break;
+			}
+		}
+		bytes -= last->query.size();
+		entries.pop_back();
+	}
+}
+
+void ParseCache::Shard::Clear() {
+	entries.clear();
+	index.clear();
+	bytes = 0;
+}
+
+void ParseCache::SetShardCapacities(idx_t new_capacity) {
+	// a capacity below SHARD_COUNT uses as many shards, so no shard in use has a share of 0 while the shares still
+	// add up to the capacity exactly: the cache never holds more than capacity queries
+	auto new_shard_count = MaxValue<idx_t>(1, MinValue<idx_t>(new_capacity, SHARD_COUNT));
+	// with another shard count the queries hash to other shards, so the cached ones can no longer be found
+	bool rehash = shard_count.exchange(new_shard_count) != new_shard_count;
+	for (idx_t i = 0; i < SHARD_COUNT; i++) {
+		auto &shard = shards[i];
+		std::lock_guard<std::mutex> guard(shard.lock);
+		if (rehash) {
+			shard.Clear();
+		}
+		bool in_use = i < new_shard_count;
+		shard.capacity = in_use ? new_capacity / new_shard_count + (i < new_capacity % new_shard_count ? 1 : 0) : 0;
+		shard.byte_capacity = in_use ? MAX_CACHED_BYTES / new_shard_count : 0;
+		shard.Evict();
+	}
+}
+
+void ParseCache::Resize(idx_t new_capacity) {
+	if (capacity.exchange(new_capacity) == new_capacity) {
+		return;
+	}
+	SetShardCapacities(new_capacity);
+}
+
+void ParseCache::Clear() {
+	for (auto &shard : shards) {
+		std::lock_guard<std::mutex> guard(shard.lock);
+		shard.Clear();
+	}
+	hits = 0;
+	misses = 0;
+}
+
+idx_t ParseCache::Size() {
+	idx_t size = 0;
+	for (auto &shard : shards) {
+		std::lock_guard<std::mutex> guard(shard.lock);
+		size += shard.entries.size();
+	}
+	return size;
+}
+
+} // namespace duckdb
@@ -1,4 +1,12 @@
 #include "poached_extension.hpp"
+#include "parse_cache.hpp"
+#include "parser_pool.hpp"
+#include "query_validation.hpp"
+#include "query_analysis.hpp"
+#include "source_span.hpp"
+#include "ast_builder.hpp"
+#include "lineage.hpp"
+#include "poached_stats.hpp"
 #include "duckdb/parser/parser.hpp"
 #include "duckdb/parser/keyword_helper.hpp"
 #include "duckdb/parser/statement/select_statement.hpp"
@@ -14,418 +22,1142 @@
 #include "duckdb/parser/expression/constant_expression.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/function/scalar_function.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_operator_expression.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/vector_operations/binary_executor.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/common/file_system.hpp"
 
-#include <cstring>
-#include <sstream>
-#include <unordered_set>
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 
 namespace duckdb {
 
 // ============================================================================
-// tokenize_sql(query) - returns tokens with byte positions and categories
+// In-out (LATERAL) support shared by the parse_* table functions
 // ============================================================================
+//
+// Each parse_* table function accepts either a constant query, which is parsed
+// once when the scan runs, or a column of another relation:
+//
+//     SELECT q.id, t.* FROM query_log q, parse_tables(q.sql_text) t
+//
+// In the second form DuckDB binds the function as a table in-out function: the
+// bind callback receives no constant inputs and the input rows are streamed
+// through `in_out_function` chunk by chunk, on every pipeline thread. The input
+// columns (and hence any row id of the outer relation) are carried along by the
+// lateral join itself.
+//
+// All of them support projection pushdown: the output chunk only holds the
+// columns the query uses, in the order of the column ids of the init input.
+// The WRITE callbacks fill just those, and the extraction skips what none of
+// them needs, such as the source spans or the printed operands of parse_where.
+
+//! The returned columns a scan produces: output column i holds returned column columns[i]. A column id beyond the
+//! returned columns (the row id, for a query that uses no column) is written as NULL.
+struct ColumnProjection {
+	explicit ColumnProjection(const vector<column_t> &column_ids) : columns(column_ids) {
+		for (auto column : columns) {
+			if (column < 64) {
+				mask |= 1ULL << column;
+			}
+		}
+	}
 
-struct TokenizeSqlBindData : public TableFunctionData {
-	string query;
-	vector<SimplifiedToken> tokens;
-};
+	bool Contains(idx_t column) const {
+		return column < 64 && ((mask >> column) & 1) != 0;
+	}
+	//! Whether any of the returned columns [begin, end) is projected
+	bool ContainsAny(idx_t begin, idx_t end) const {
+		for (auto column = begin; column < end; column++) {
+			if (Contains(column)) {
+				return true;
+			}
+		}
+		return false;
+	}
 
-struct TokenizeSqlState : public GlobalTableFunctionState {
-	idx_t current_idx = 0;
+	vector<column_t> columns;
+	//! Bit i is set if returned column i is projected
+	uint64_t mask = 0;
 };
 
-static unique_ptr<FunctionData> TokenizeSqlBind(ClientContext &context, TableFunctionBindInput &input,
-                                                 vector<LogicalType> &return_types, vector<string> &names) {
-	auto result = make_uniq<TokenizeSqlBindData>();
-	result->query = input.inputs[0].GetValue<string>();
-	result->tokens = Parser::Tokenize(result->query);
-
-	return_types.push_back(LogicalType::BIGINT);
-	names.push_back("byte_position");
-	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("category");
+template <class ROW>
+struct ParseInOutState : public LocalTableFunctionState {
+	explicit ParseInOutState(const vector<column_t> &column_ids) : projection(column_ids) {
+	}
 
-	return std::move(result);
-}
+	ColumnProjection projection;
+	//! The query column of the current input chunk, converted once per chunk
+	UnifiedVectorFormat query_data;
+	//! Next row of the current input chunk
+	idx_t input_idx = 0;
+	//! Result rows produced for the input row being emitted
+	vector<ROW> rows;
+	idx_t row_idx = 0;
+	bool has_pending = false;
+};
 
-static unique_ptr<GlobalTableFunctionState> TokenizeSqlInit(ClientContext &context, TableFunctionInitInput &input) {
-	return make_uniq<TokenizeSqlState>();
+template <class ROW>
+static unique_ptr<LocalTableFunctionState> ParseInOutInitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                               GlobalTableFunctionState *global_state) {
+	return make_uniq<ParseInOutState<ROW>>(input.column_ids);
 }
 
-static string TokenTypeToString(SimplifiedTokenType type) {
-	switch (type) {
-	case SimplifiedTokenType::SIMPLIFIED_TOKEN_IDENTIFIER: return "IDENTIFIER";
-	case SimplifiedTokenType::SIMPLIFIED_TOKEN_NUMERIC_CONSTANT: return "NUMERIC_CONSTANT";
-	case SimplifiedTokenType::SIMPLIFIED_TOKEN_STRING_CONSTANT: return "STRING_CONSTANT";
-	case SimplifiedTokenType::SIMPLIFIED_TOKEN_OPERATOR: return "OPERATOR";
-	case SimplifiedTokenType::SIMPLIFIED_TOKEN_KEYWORD: return "KEYWORD";
-	case SimplifiedTokenType::SIMPLIFIED_TOKEN_COMMENT: return "COMMENT";
-	default: return "ERROR";
+// Fetch the query of an in-out input row from the query column of its chunk, returns false for NULL
+static bool GetInOutString(const UnifiedVectorFormat &query_data, idx_t row_idx, string &result) {
+	auto idx = query_data.sel->get_index(row_idx);
+	if (!query_data.validity.RowIsValid(idx)) {
+		return false;
 	}
+	auto &query = UnifiedVectorFormat::GetData<string_t>(query_data)[idx];
+	result.assign(query.GetData(), query.GetSize());
+	PoachedStats::Add(PoachedStat::BYTES_IN, result.size());
+	return true;
 }
 
-static void TokenizeSqlFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
-	auto &bind_data = data_p.bind_data->Cast<TokenizeSqlBindData>();
-	auto &state = data_p.global_state->Cast<TokenizeSqlState>();
-
-	idx_t count = 0;
-	while (state.current_idx < bind_data.tokens.size() && count < STANDARD_VECTOR_SIZE) {
-		auto &token = bind_data.tokens[state.current_idx];
-		output.data[0].SetValue(count, Value::BIGINT(token.start));
-		output.data[1].SetValue(count, Value(TokenTypeToString(token.type)));
-		count++;
-		state.current_idx++;
-	}
-	output.SetCardinality(count);
+static vector<SimplifiedToken> TokenizeTimed(const string &query) {
+	PoachedStatsTimer timer(PoachedStat::TOKENIZE_TIME_NS);
+	return Parser::Tokenize(query);
 }
 
 // ============================================================================
-// Scalar functions
+// Parse limits - poached_max_query_bytes, poached_max_nesting_depth, poached_max_query_tokens
 // ============================================================================
+//
+// The parser cannot be interrupted, and pathological queries (deeply nested expressions, huge IN lists) take it
+// seconds and a lot of memory. Queries over the limits are rejected before they are parsed, by a scan of their bytes
+// that skips strings and comments, counts tokens and tracks the nesting of parentheses, brackets and CASE; they
+// then give the limit error like a parse error. The token count bounds the parse work of a query.
+
+struct ParseLimits {
+	//! 0 is no limit
+	idx_t max_bytes = 0;
+	idx_t max_depth = 0;
+	idx_t max_tokens = 0;
+
+	bool IsSet() const {
+		return max_bytes != 0 || max_depth != 0 || max_tokens != 0;
+	}
+	//! The error message for a query over the limits, empty if it is within them
+	string Check(const char *data, idx_t size) const;
+};
 
-static void IsValidSqlFunc(DataChunk &args, ExpressionState &state, Vector &result) {
-	UnaryExecutor::Execute<string_t, bool>(args.data[0], result, args.size(), [&](string_t query) {
-		try {
-			Parser parser;
-			parser.ParseQuery(query.GetString());
-			return true;
-		} catch (...) {
-			return false;
-		}
-	});
+static idx_t GetLimitSetting(ClientContext &context, const char *name) {
+	Value setting;
+	if (context.TryGetCurrentSetting(name, setting) && !setting.IsNull()) {
+		return setting.GetValue<uint64_t>();
+	}
+	return 0;
 }
 
-static void SqlErrorMessageFunc(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &input = args.data[0];
-	auto count = args.size();
-
-	UnifiedVectorFormat vdata;
-	input.ToUnifiedFormat(count, vdata);
-	auto input_data = UnifiedVectorFormat::GetData<string_t>(vdata);
+static ParseLimits GetParseLimits(ClientContext &context) {
+	ParseLimits limits;
+	limits.max_bytes = GetLimitSetting(context, "poached_max_query_bytes");
+	limits.max_depth = GetLimitSetting(context, "poached_max_nesting_depth");
+	limits.max_tokens = GetLimitSetting(context, "poached_max_query_tokens");
+	return limits;
+}
 
-	result.SetVectorType(VectorType::FLAT_VECTOR);
-	auto result_data = FlatVector::GetData<string_t>(result);
-	auto &result_validity = FlatVector::Validity(result);
+//! Bind data of the table functions that parse their input, holding the parse limits of the binding context
+struct ParseFunctionData : public TableFunctionData {
+	ParseLimits limits;
+	//! Values of the function's filterable column (stmt_type, context or function_type) that the query's filters
+	//! accept, see ParsePushdownFilter
+	ValueFilter filter;
+};
 
-	for (idx_t i = 0; i < count; i++) {
-		auto idx = vdata.sel->get_index(i);
-		if (!vdata.validity.RowIsValid(idx)) {
-			result_validity.SetInvalid(i);
-			continue;
+// ============================================================================
+// Filter pushdown on the classification columns
+// ============================================================================
+//
+// Queries mostly filter the extracted rows on what they are, e.g. WHERE context = 'JOIN' or WHERE function_type IN
+// ('aggregate', 'window'). Such equality and IN filters on the stmt_type, context or function_type column are
+// pushed into the bind data as a ValueFilter: rows it rejects are not produced, and the analyzer skips the parts of
+// a statement that cannot hold an accepted row. The filters themselves stay in the plan, so DuckDB still applies
+// them exactly and the pushdown only has to never drop a row that passes.
+
+// Whether filter compares a column of get with constant strings, as `column = 'x'` or `column IN ('x', 'y')`; if so,
+// sets the column's returned column index and the strings
+static bool GetEqualityFilter(LogicalGet &get, Expression &filter, column_t &column, unordered_set<string> &values) {
+	Expression *column_expr;
+	vector<Expression *> constants;
+	if (filter.GetExpressionClass() == ExpressionClass::BOUND_COMPARISON &&
+	    filter.type == ExpressionType::COMPARE_EQUAL) {
+		auto &comparison = filter.Cast<BoundComparisonExpression>();
+		column_expr = comparison.left.get();
+		constants.push_back(comparison.right.get());
+		if (column_expr->GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+			std::swap(column_expr, constants[0]);
 		}
-
-		auto query_str = input_data[idx].GetString();
-		try {
-			Parser parser;
-			parser.ParseQuery(query_str);
-			// Valid SQL - return NULL
-			result_validity.SetInvalid(i);
-		} catch (const Exception &e) {
-			result_data[i] = StringVector::AddString(result, e.what());
-		} catch (const std::exception &e) {
-			result_data[i] = StringVector::AddString(result, e.what());
+	} else if (filter.GetExpressionClass() == ExpressionClass::BOUND_OPERATOR &&
+	           filter.type == ExpressionType::COMPARE_IN) {
+		auto &op = filter.Cast<BoundOperatorExpression>();
+		column_expr = op.children[0].get();
+		for (idx_t i = 1; i < op.children.size(); i++) {
+			constants.push_back(op.children[i].get());
+		}
+	} else {
+		return false;
+	}
+	if (column_expr->GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+		return false;
+	}
+	auto &ref = column_expr->Cast<BoundColumnRefExpression>();
+	if (ref.depth != 0 || ref.binding.table_index != get.table_index) {
+		return false;
+	}
+	for (auto constant : constants) {
+		if (constant->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+			return false;
+		}
+		auto &value = constant->Cast<BoundConstantExpression>().value;
+		if (value.type().id() != LogicalTypeId::VARCHAR) {
+			return false;
+		}
+		// NULL equals nothing: it accepts no value
+		if (!value.IsNull()) {
+			values.insert(StringValue::Get(value));
 		}
 	}
+	column = get.GetColumnIds()[ref.binding.column_index].GetPrimaryIndex();
+	return true;
 }
 
-static void NumStatementsFunc(DataChunk &args, ExpressionState &state, Vector &result) {
-	UnaryExecutor::Execute<string_t, int64_t>(args.data[0], result, args.size(), [&](string_t query) {
-		try {
-			Parser parser;
-			parser.ParseQuery(query.GetString());
-			return static_cast<int64_t>(parser.statements.size());
-		} catch (...) {
-			return static_cast<int64_t>(0);
+// pushdown_complex_filter callback restricting the filter of the bind data by the filters on returned column COLUMN
+template <column_t COLUMN>
+static void ParsePushdownFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data,
+                                vector<unique_ptr<Expression>> &filters) {
+	auto &data = bind_data->Cast<ParseFunctionData>();
+	for (auto &filter : filters) {
+		column_t column;
+		unordered_set<string> values;
+		if (GetEqualityFilter(get, *filter, column, values) && column == COLUMN) {
+			data.filter.Restrict(values);
 		}
-	});
+	}
 }
 
-static void IsKeywordFunc(DataChunk &args, ExpressionState &state, Vector &result) {
-	UnaryExecutor::Execute<string_t, bool>(args.data[0], result, args.size(), [&](string_t str) {
-		return KeywordHelper::IsKeyword(str.GetString());
-	});
+static bool IsWordByte(char c) {
+	return StringUtil::CharacterIsAlphaNumeric(c) || c == '_' || static_cast<uint8_t>(c) >= 0x80;
 }
 
-// ============================================================================
-// sql_keywords() - list all SQL keywords
-// ============================================================================
+// Whether the word [data, data + size) is the (lower-case) keyword, case-insensitively
+static bool WordIsKeyword(const char *data, idx_t size, const char *keyword) {
+	idx_t i = 0;
+	for (; i < size && keyword[i]; i++) {
+		if (StringUtil::CharacterToLower(data[i]) != keyword[i]) {
+			return false;
+		}
+	}
+	return i == size && !keyword[i];
+}
 
-struct SqlKeywordsBindData : public TableFunctionData {
-	vector<string> keywords;
-};
+string ParseLimits::Check(const char *data, idx_t size) const {
+	if (max_bytes != 0 && size > max_bytes) {
+		return StringUtil::Format("query of %d bytes exceeds poached_max_query_bytes (%d)", size, max_bytes);
+	}
+	if (max_depth == 0 && max_tokens == 0) {
+		return string();
+	}
+	idx_t tokens = 0;
+	idx_t bracket_depth = 0;
+	idx_t case_depth = 0;
+	idx_t pos = 0;
+	while (pos < size) {
+		auto c = data[pos];
+		if (StringUtil::CharacterIsSpace(c)) {
+			pos++;
+			continue;
+		}
+		auto next = pos + 1 < size ? data[pos + 1] : '\0';
+		if (c == '-' && next == '-') {
+			auto newline = static_cast<const char *>(memchr(data + pos, '\n', size - pos));
+			pos = newline ? NumericCast<idx_t>(newline - data) : size;
+			continue;
+		}
+		if (c == '/' && next == '*') {
+			pos = FindBlockCommentEnd(data, pos + 2, size);
+			continue;
+		}
+		tokens++;
+		if (c == '\'' || c == '"') {
+			pos = SkipStringLiteral(data, pos, size);
+		} else if (IsWordByte(c)) {
+			auto start = pos;
+			while (pos < size && IsWordByte(data[pos])) {
+				pos++;
+			}
+			if (WordIsKeyword(data + start, pos - start, "case")) {
+				case_depth++;
+			} else if (case_depth > 0 && WordIsKeyword(data + start, pos - start, "end")) {
+				case_depth--;
+			}
+		} else {
+			if (c == '(' || c == '[') {
+				bracket_depth++;
+			} else if ((c == ')' || c == ']') && bracket_depth > 0) {
+				bracket_depth--;
+			}
+			pos++;
+		}
+		if (max_tokens != 0 && tokens > max_tokens) {
+			return StringUtil::Format("query has more than %d tokens, exceeding poached_max_query_tokens", max_tokens);
+		}
+		if (max_depth != 0 && bracket_depth + case_depth > max_depth) {
+			return StringUtil::Format("query nests deeper than %d levels, exceeding poached_max_nesting_depth",
+			                          max_depth);
+		}
+	}
+	return string();
+}
 
-struct SqlKeywordsState : public GlobalTableFunctionState {
-	idx_t current_idx = 0;
-};
+// Parse query into parser, counting the time spent in the parser
+static void ParseQueryTimed(Parser &parser, const string &query) {
+	PoachedStatsTimer timer(PoachedStat::PARSE_TIME_NS);
+	parser.ParseQuery(query);
+}
 
-static unique_ptr<FunctionData> SqlKeywordsBind(ClientContext &context, TableFunctionBindInput &input,
-                                                 vector<LogicalType> &return_types, vector<string> &names) {
-	auto result = make_uniq<SqlKeywordsBindData>();
-	auto keywords = Parser::KeywordList();
-	for (auto &kw : keywords) {
-		result->keywords.push_back(kw.name);
+// Source spans are reported as the columns start_byte, end_byte, line_number and column_number
+static void AddSpanColumns(vector<LogicalType> &return_types, vector<string> &names) {
+	for (auto name : {"start_byte", "end_byte", "line_number", "column_number"}) {
+		return_types.push_back(LogicalType::BIGINT);
+		names.push_back(name);
 	}
+}
 
-	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("keyword");
+static constexpr idx_t SPAN_COLUMN_COUNT = 4;
 
-	return std::move(result);
+// Whether any span column is projected, for span columns starting at returned column col_idx
+static bool ProjectsSpan(const ColumnProjection &projection, idx_t col_idx) {
+	return projection.ContainsAny(col_idx, col_idx + SPAN_COLUMN_COUNT);
 }
 
-static unique_ptr<GlobalTableFunctionState> SqlKeywordsInit(ClientContext &context, TableFunctionInitInput &input) {
-	return make_uniq<SqlKeywordsState>();
+// Write span column field (0 for start_byte to 3 for column_number) of a span, NULL if the span is unknown. A field
+// beyond the span columns is a column the function does not return, it is NULL too.
+static void WriteSpanField(Vector &vector, idx_t field, idx_t out_idx, const SourceSpan &span) {
+	if (!span.IsValid() || field >= SPAN_COLUMN_COUNT) {
+		FlatVector::SetNull(vector, out_idx, true);
+		return;
+	}
+	idx_t value;
+	switch (field) {
+	case 0:
+		value = span.start_byte;
+		break;
+	case 1:
+		value = span.end_byte;
+		break;
+	case 2:
+		value = span.line;
+		break;
+	default:
+		value = span.column;
+		break;
+	}
+	FlatVector::GetData<int64_t>(vector)[out_idx] = NumericCast<int64_t>(value);
 }
 
-static void SqlKeywordsFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
-	auto &bind_data = data_p.bind_data->Cast<SqlKeywordsBindData>();
-	auto &state = data_p.global_state->Cast<SqlKeywordsState>();
+// COLLECT fills the result rows for one input row, given the query column of the input chunk, WRITE stores the
+// projected columns of one result row in the output chunk
+template <class ROW,
+          void (*COLLECT)(const FunctionData &bind_data, const ColumnProjection &projection, DataChunk &input,
+                          const UnifiedVectorFormat &query_data, idx_t row_idx, vector<ROW> &rows),
+          void (*WRITE)(DataChunk &output, const ColumnProjection &projection, idx_t out_idx, const ROW &row)>
+static OperatorResultType ParseInOutFunction(ExecutionContext &context, TableFunctionInput &data_p, DataChunk &input,
+                                             DataChunk &output) {
+	auto &state = data_p.local_state->Cast<ParseInOutState<ROW>>();
 
 	idx_t count = 0;
-	while (state.current_idx < bind_data.keywords.size() && count < STANDARD_VECTOR_SIZE) {
-		output.data[0].SetValue(count, Value(bind_data.keywords[state.current_idx]));
-		count++;
-		state.current_idx++;
+	while (count < STANDARD_VECTOR_SIZE) {
+		if (!state.has_pending) {
+			if (state.input_idx >= input.size()) {
+				// this input chunk is exhausted
+				state.input_idx = 0;
+				output.SetCardinality(count);
+				return OperatorResultType::NEED_MORE_INPUT;
+			}
+			if (state.input_idx == 0) {
+				input.data[0].ToUnifiedFormat(input.size(), state.query_data);
+			}
+			state.rows.clear();
+			state.row_idx = 0;
+			COLLECT(*data_p.bind_data, state.projection, input, state.query_data, state.input_idx++, state.rows);
+			state.has_pending = true;
+		}
+		while (state.row_idx < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+			WRITE(output, state.projection, count++, state.rows[state.row_idx++]);
+		}
+		if (state.row_idx >= state.rows.size()) {
+			state.has_pending = false;
+		}
 	}
 	output.SetCardinality(count);
+	return OperatorResultType::HAVE_MORE_OUTPUT;
 }
 
 // ============================================================================
-// parse_keyword_names() - Returns keyword names as array
+// tokenize_sql(query) - returns tokens with byte positions and categories
 // ============================================================================
 
-static void ParseKeywordNamesFunc(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto keywords = Parser::KeywordList();
-	auto count = args.size();
-
-	result.SetVectorType(VectorType::FLAT_VECTOR);
-	auto result_data = FlatVector::GetData<list_entry_t>(result);
-	auto &child = ListVector::GetEntry(result);
-	idx_t current_size = ListVector::GetListSize(result);
-	idx_t keyword_count = keywords.size();
+// Token categories, in the order of the values of the category ENUM
+static constexpr const char *TOKEN_CATEGORIES[] = {"IDENTIFIER", "NUMERIC_CONSTANT", "STRING_CONSTANT", "OPERATOR",
+                                                   "KEYWORD",    "COMMENT",          "ERROR"};
+static constexpr idx_t TOKEN_CATEGORY_COUNT = sizeof(TOKEN_CATEGORIES) / sizeof(TOKEN_CATEGORIES[0]);
+
+enum TokenCategory : uint8_t {
+	TOKEN_IDENTIFIER,
+	TOKEN_NUMERIC_CONSTANT,
+	TOKEN_STRING_CONSTANT,
+	TOKEN_OPERATOR,
+	TOKEN_KEYWORD,
+	TOKEN_COMMENT,
+	TOKEN_ERROR
+};
 
-	for (idx_t row = 0; row < count; row++) {
-		ListVector::Reserve(result, current_size + keyword_count);
-		auto start = current_size;
-		for (auto &kw : keywords) {
-			child.SetValue(current_size++, Value(kw.name));
-		}
-		result_data[row] = list_entry_t{start, keyword_count};
+static uint8_t TokenTypeToCategory(SimplifiedTokenType type) {
+	switch (type) {
+	case SimplifiedTokenType::SIMPLIFIED_TOKEN_IDENTIFIER: return TOKEN_IDENTIFIER;
+	case SimplifiedTokenType::SIMPLIFIED_TOKEN_NUMERIC_CONSTANT: return TOKEN_NUMERIC_CONSTANT;
+	case SimplifiedTokenType::SIMPLIFIED_TOKEN_STRING_CONSTANT: return TOKEN_STRING_CONSTANT;
+	case SimplifiedTokenType::SIMPLIFIED_TOKEN_OPERATOR: return TOKEN_OPERATOR;
+	case SimplifiedTokenType::SIMPLIFIED_TOKEN_KEYWORD: return TOKEN_KEYWORD;
+	case SimplifiedTokenType::SIMPLIFIED_TOKEN_COMMENT: return TOKEN_COMMENT;
+	default: return TOKEN_ERROR;
 	}
+}
 
-	ListVector::SetListSize(result, current_size);
+static LogicalType TokenCategoryType() {
+	Vector categories(LogicalType::VARCHAR, TOKEN_CATEGORY_COUNT);
+	auto data = FlatVector::GetData<string_t>(categories);
+	for (idx_t i = 0; i < TOKEN_CATEGORY_COUNT; i++) {
+		data[i] = StringVector::AddString(categories, TOKEN_CATEGORIES[i]);
+	}
+	return LogicalType::ENUM(categories, TOKEN_CATEGORY_COUNT);
 }
 
-// ============================================================================
-// parse_statements(query) - parse multi-statement SQL
-// ============================================================================
+struct TokenRow {
+	int64_t start;
+	int64_t length;
+	uint8_t category;
+};
 
-struct ParseStatementsBindData : public TableFunctionData {
-	string query;
-	vector<unique_ptr<SQLStatement>> statements;
-	string error;
+// Tokenize a query; a token ends before the whitespace and comments between it and the next one
+static void TokenizeQuery(const string &query, vector<TokenRow> &rows) {
+	auto tokens = TokenizeTimed(query);
+	rows.resize(tokens.size());
+	for (idx_t i = 0; i < tokens.size(); i++) {
+		idx_t start = tokens[i].start;
+		idx_t end = TokenTextEnd(query.data(), start, i + 1 < tokens.size() ? tokens[i + 1].start : query.size());
+		rows[i].start = static_cast<int64_t>(start);
+		rows[i].length = static_cast<int64_t>(end - start);
+		rows[i].category = TokenTypeToCategory(tokens[i].type);
+	}
+}
+
+struct TokenizeSqlBindData : public TableFunctionData {
+	vector<TokenRow> tokens;
 };
 
-struct ParseStatementsState : public GlobalTableFunctionState {
+struct TokenizeSqlState : public GlobalTableFunctionState {
+	explicit TokenizeSqlState(const vector<column_t> &column_ids) : projection(column_ids) {
+	}
+
+	ColumnProjection projection;
 	idx_t current_idx = 0;
 };
 
-static unique_ptr<FunctionData> ParseStatementsBind(ClientContext &context, TableFunctionBindInput &input,
-                                                     vector<LogicalType> &return_types, vector<string> &names) {
-	auto result = make_uniq<ParseStatementsBindData>();
-	result->query = input.inputs[0].GetValue<string>();
-
-	try {
-		Parser parser;
-		parser.ParseQuery(result->query);
-		result->statements = std::move(parser.statements);
-	} catch (const Exception &e) {
-		result->error = e.what();
+static unique_ptr<FunctionData> TokenizeSqlBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<TokenizeSqlBindData>();
+	if (!input.inputs.empty()) {
+		TokenizeQuery(input.inputs[0].GetValue<string>(), result->tokens);
 	}
 
 	return_types.push_back(LogicalType::BIGINT);
-	names.push_back("stmt_index");
-	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("stmt_type");
-	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("error");
+	names.push_back("byte_position");
+	return_types.push_back(TokenCategoryType());
+	names.push_back("category");
 	return_types.push_back(LogicalType::BIGINT);
-	names.push_back("param_count");
+	names.push_back("byte_length");
 
 	return std::move(result);
 }
 
-static unique_ptr<GlobalTableFunctionState> ParseStatementsInit(ClientContext &context, TableFunctionInitInput &input) {
-	return make_uniq<ParseStatementsState>();
+static unique_ptr<GlobalTableFunctionState> TokenizeSqlInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<TokenizeSqlState>(input.column_ids);
 }
 
-static void ParseStatementsFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
-	auto &bind_data = data_p.bind_data->Cast<ParseStatementsBindData>();
-	auto &state = data_p.global_state->Cast<ParseStatementsState>();
+static void WriteTokenRow(DataChunk &output, const ColumnProjection &projection, idx_t out_idx, const TokenRow &token) {
+	for (idx_t col_idx = 0; col_idx < projection.columns.size(); col_idx++) {
+		auto &vector = output.data[col_idx];
+		switch (projection.columns[col_idx]) {
+		case 0:
+			FlatVector::GetData<int64_t>(vector)[out_idx] = token.start;
+			break;
+		case 1:
+			FlatVector::GetData<uint8_t>(vector)[out_idx] = token.category;
+			break;
+		case 2:
+			FlatVector::GetData<int64_t>(vector)[out_idx] = token.length;
+			break;
+		default:
+			FlatVector::SetNull(vector, out_idx, true);
+			break;
+		}
+	}
+}
 
-	idx_t count = 0;
+static void TokenizeSqlFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &bind_data = data_p.bind_data->Cast<TokenizeSqlBindData>();
+	auto &state = data_p.global_state->Cast<TokenizeSqlState>();
 
-	if (!bind_data.error.empty() && state.current_idx == 0) {
-		output.data[0].SetValue(count, Value::BIGINT(0));
-		output.data[1].SetValue(count, Value());
-		output.data[2].SetValue(count, Value(bind_data.error));
-		output.data[3].SetValue(count, Value::BIGINT(0));
-		count++;
-		state.current_idx++;
-		output.SetCardinality(count);
-		return;
+	auto count = MinValue<idx_t>(bind_data.tokens.size() - state.current_idx, STANDARD_VECTOR_SIZE);
+	auto tokens = bind_data.tokens.data() + state.current_idx;
+	// filled a column at a time
+	auto &columns = state.projection.columns;
+	for (idx_t col_idx = 0; col_idx < columns.size(); col_idx++) {
+		auto &vector = output.data[col_idx];
+		if (columns[col_idx] == 0) {
+			auto positions = FlatVector::GetData<int64_t>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				positions[i] = tokens[i].start;
+			}
+		} else if (columns[col_idx] == 1) {
+			auto categories = FlatVector::GetData<uint8_t>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				categories[i] = tokens[i].category;
+			}
+		} else if (columns[col_idx] == 2) {
+			auto lengths = FlatVector::GetData<int64_t>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				lengths[i] = tokens[i].length;
+			}
+		} else {
+			for (idx_t i = 0; i < count; i++) {
+				FlatVector::SetNull(vector, i, true);
+			}
+		}
 	}
+	state.current_idx += count;
+	output.SetCardinality(count);
+}
 
-	while (state.current_idx < bind_data.statements.size() && count < STANDARD_VECTOR_SIZE) {
-		auto &stmt = bind_data.statements[state.current_idx];
-		output.data[0].SetValue(count, Value::BIGINT(state.current_idx));
-		output.data[1].SetValue(count, Value(StatementTypeToString(stmt->type)));
-		output.data[2].SetValue(count, Value());
-		output.data[3].SetValue(count, Value::BIGINT(0));
-		count++;
-		state.current_idx++;
+static void TokenizeSqlInOutCollect(const FunctionData &bind_data, const ColumnProjection &projection,
+                                    DataChunk &input, const UnifiedVectorFormat &query_data, idx_t row_idx,
+                                    vector<TokenRow> &rows) {
+	string query;
+	if (GetInOutString(query_data, row_idx, query)) {
+		TokenizeQuery(query, rows);
 	}
-	output.SetCardinality(count);
 }
 
 // ============================================================================
-// Helper: Extract table references from a statement
+// parse_tokens_delta(query, edit_start, old_edit_end, new_edit_end, previous_tokens)
+// - re-tokenize only the part of an edited query that changed
 // ============================================================================
+//
+// The edit replaced bytes [edit_start, old_edit_end) of the previous text with bytes [edit_start, new_edit_end) of
+// query, and previous_tokens is the `list(t)` of the previous parse_tokens result. Tokenizing restarts at the end of
+// the last previous token that ends before the edit (the lexer is in its initial state there) and stops as soon as a
+// new token behind the edit lines up with a previous token: from there on the text, and hence the tokens, are the
+// same as before, shifted by the size change of the edit. The result holds the new tokens that replace previous
+// tokens [start_index, previous_end_index), so the work depends on the size of the edit, not of the query.
+
+static constexpr idx_t TOKENS_DELTA_INITIAL_WINDOW = 1024;
+
+struct TokensDeltaBindData : public FunctionData {
+	TokensDeltaBindData(idx_t position_idx_p, idx_t length_idx_p)
+	    : position_idx(position_idx_p), length_idx(length_idx_p) {
+	}
 
-struct ExtractedTable {
-	string schema;
-	string table;
-	string context; // "FROM", "JOIN", "INSERT", etc.
-};
-
-static void ExtractTablesFromTableRef(duckdb::TableRef *tref, vector<ExtractedTable> &tables, const string &ctx);
-
-static void ExtractTablesFromQueryNode(QueryNode *node, vector<ExtractedTable> &tables) {
-	if (!node) return;
+	//! Index of the byte_position / byte_length fields in the previous_tokens structs
+	idx_t position_idx;
+	idx_t length_idx;
 
-	if (node->type == QueryNodeType::SELECT_NODE) {
-		auto &select = node->Cast<SelectNode>();
-		if (select.from_table) {
-			ExtractTablesFromTableRef(select.from_table.get(), tables, "FROM");
-		}
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<TokensDeltaBindData>(position_idx, length_idx);
 	}
-
-	// Handle CTEs
-	for (auto &cte : node->cte_map.map) {
-		if (cte.second && cte.second->query) {
-			ExtractTablesFromQueryNode(cte.second->query->node.get(), tables);
-		}
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<TokensDeltaBindData>();
+		return position_idx == other.position_idx && length_idx == other.length_idx;
 	}
+};
+
+static LogicalType TokenStructType() {
+	child_list_t<LogicalType> children;
+	children.push_back(make_pair("byte_position", LogicalType::BIGINT));
+	children.push_back(make_pair("category", TokenCategoryType()));
+	children.push_back(make_pair("byte_length", LogicalType::BIGINT));
+	return LogicalType::STRUCT(std::move(children));
 }
 
-static void ExtractTablesFromTableRef(duckdb::TableRef *tref, vector<ExtractedTable> &tables, const string &ctx) {
-	if (!tref) return;
+// Append tokens to a LIST(TokenStructType()) vector
+static list_entry_t AppendTokenList(Vector &list, const vector<TokenRow> &tokens) {
+	auto offset = ListVector::GetListSize(list);
+	ListVector::Reserve(list, offset + tokens.size());
+	auto &fields = StructVector::GetEntries(ListVector::GetEntry(list));
+	auto positions = FlatVector::GetData<int64_t>(*fields[0]);
+	auto categories = FlatVector::GetData<uint8_t>(*fields[1]);
+	auto lengths = FlatVector::GetData<int64_t>(*fields[2]);
+	for (idx_t i = 0; i < tokens.size(); i++) {
+		positions[offset + i] = tokens[i].start;
+		categories[offset + i] = tokens[i].category;
+		lengths[offset + i] = tokens[i].length;
+	}
+	ListVector::SetListSize(list, offset + tokens.size());
+	return list_entry_t {offset, tokens.size()};
+}
 
-	switch (tref->type) {
-	case TableReferenceType::BASE_TABLE: {
-		auto &base = tref->Cast<BaseTableRef>();
-		ExtractedTable t;
-		t.schema = base.schema_name;
-		t.table = base.table_name;
-		t.context = ctx;
-		tables.push_back(t);
-		break;
+static unique_ptr<FunctionData> ParseTokensDeltaBind(ClientContext &context, ScalarFunction &bound_function,
+                                                     vector<unique_ptr<Expression>> &arguments) {
+	auto &previous_type = arguments[4]->return_type;
+	if (previous_type.id() == LogicalTypeId::SQLNULL) {
+		return make_uniq<TokensDeltaBindData>(0, 0);
 	}
-	case TableReferenceType::JOIN: {
-		auto &join = tref->Cast<JoinRef>();
-		ExtractTablesFromTableRef(join.left.get(), tables, ctx);
-		ExtractTablesFromTableRef(join.right.get(), tables, "JOIN");
-		break;
+	if (previous_type.id() != LogicalTypeId::LIST ||
+	    ListType::GetChildType(previous_type).id() != LogicalTypeId::STRUCT) {
+		throw BinderException("parse_tokens_delta: previous_tokens must be a list of parse_tokens rows, got %s",
+		                      previous_type.ToString());
 	}
-	case TableReferenceType::SUBQUERY: {
-		auto &subq = tref->Cast<SubqueryRef>();
-		if (subq.subquery && subq.subquery->node) {
-			ExtractTablesFromQueryNode(subq.subquery->node.get(), tables);
+	optional_idx position_idx, length_idx;
+	auto &fields = StructType::GetChildTypes(ListType::GetChildType(previous_type));
+	for (idx_t i = 0; i < fields.size(); i++) {
+		if (fields[i].second.id() != LogicalTypeId::BIGINT) {
+			continue;
 		}
-		break;
-	}
-	case TableReferenceType::TABLE_FUNCTION: {
-		auto &func = tref->Cast<TableFunctionRef>();
-		if (func.function) {
-			auto &fn = func.function->Cast<FunctionExpression>();
-			ExtractedTable t;
-			t.schema = fn.schema;
-			t.table = fn.function_name;
-			t.context = "TABLE_FUNCTION";
-			tables.push_back(t);
+		if (fields[i].first == "byte_position") {
+			position_idx = i;
+		} else if (fields[i].first == "byte_length") {
+			length_idx = i;
 		}
-		break;
 	}
-	default:
-		break;
+	if (!position_idx.IsValid() || !length_idx.IsValid()) {
+		throw BinderException(
+		    "parse_tokens_delta: previous_tokens must have BIGINT byte_position and byte_length fields");
 	}
+	return make_uniq<TokensDeltaBindData>(position_idx.GetIndex(), length_idx.GetIndex());
 }
 
-static void ExtractTablesFromStatement(SQLStatement *stmt, vector<ExtractedTable> &tables) {
-	if (!stmt) return;
+struct TokensDelta {
+	idx_t start_index = 0;
+	idx_t previous_end_index = 0;
+	vector<TokenRow> tokens;
+	//! The text and tokens of the current window, kept to reuse their buffers
+	string window_text;
+	vector<TokenRow> window_tokens;
+};
 
-	if (stmt->type == StatementType::SELECT_STATEMENT) {
-		auto &select = stmt->Cast<SelectStatement>();
-		if (select.node) {
-			ExtractTablesFromQueryNode(select.node.get(), tables);
+static void ComputeTokensDelta(const string &query, idx_t edit_start, idx_t old_edit_end, idx_t new_edit_end,
+                               const vector<int64_t> &prev_pos, const vector<int64_t> &prev_len, TokensDelta &delta) {
+	auto prev_count = prev_pos.size();
+	auto edit_start_pos = static_cast<int64_t>(edit_start);
+	// previous token ends only grow, so binary search for the tokens that end before the edit
+	idx_t lo = 0, hi = prev_count;
+	while (lo < hi) {
+		auto mid = lo + (hi - lo) / 2;
+		if (prev_pos[mid] + prev_len[mid] < edit_start_pos) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	delta.start_index = lo;
+	idx_t scan_start = lo > 0 ? static_cast<idx_t>(prev_pos[lo - 1] + prev_len[lo - 1]) : 0;
+	scan_start = MinValue<idx_t>(scan_start, query.size());
+	auto shift = static_cast<int64_t>(new_edit_end) - static_cast<int64_t>(old_edit_end);
+
+	idx_t window = MaxValue<idx_t>(new_edit_end, scan_start) - scan_start + TOKENS_DELTA_INITIAL_WINDOW;
+	auto &rows = delta.tokens;
+	auto &window_rows = delta.window_tokens;
+	rows.clear();
+	idx_t prev_idx = delta.start_index;
+	while (true) {
+		bool at_end = scan_start + window >= query.size();
+		delta.window_text.assign(query, scan_start, window);
+		TokenizeQuery(delta.window_text, window_rows);
+		// the last token of a truncated window may be cut off, only complete tokens can line up
+		idx_t complete = at_end || window_rows.empty() ? window_rows.size() : window_rows.size() - 1;
+
+		for (idx_t k = 0; k < complete; k++) {
+			auto pos = window_rows[k].start + static_cast<int64_t>(scan_start);
+			if (pos >= static_cast<int64_t>(new_edit_end)) {
+				auto old_pos = pos - shift;
+				while (prev_idx < prev_count &&
+				       (prev_pos[prev_idx] < old_pos || prev_pos[prev_idx] < static_cast<int64_t>(old_edit_end))) {
+					prev_idx++;
+				}
+				if (prev_idx < prev_count && prev_pos[prev_idx] == old_pos &&
+				    prev_len[prev_idx] == window_rows[k].length) {
+					// everything from this token on is unchanged
+					delta.previous_end_index = prev_idx;
+					return;
+				}
+			}
+			rows.push_back(TokenRow {pos, window_rows[k].length, window_rows[k].category});
+		}
+		if (at_end) {
+			delta.previous_end_index = prev_count;
+			return;
+		}
+		// the next, twice as large window starts at the cut-off token (a token start, so the lexer is in its initial
+		// state there): the complete tokens are tokenized only once. A window without tokens may end inside an
+		// unterminated comment or literal, so it is tokenized again.
+		if (!window_rows.empty()) {
+			scan_start += NumericCast<idx_t>(window_rows[complete].start);
 		}
+		window *= 2;
 	}
 }
 
-// ============================================================================
-// parse_tables(query) - Extract table references
-// ============================================================================
-
-struct ParseTablesBindData : public TableFunctionData {
-	vector<ExtractedTable> tables;
-	string error;
-};
+static void ParseTokensDeltaFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &bind_data = func_expr.bind_info->Cast<TokensDeltaBindData>();
+	auto count = args.size();
 
-struct ParseTablesState : public GlobalTableFunctionState {
-	idx_t current_idx = 0;
-};
+	UnifiedVectorFormat query_data, start_data, old_end_data, new_end_data, prev_data;
+	args.data[0].ToUnifiedFormat(count, query_data);
+	args.data[1].ToUnifiedFormat(count, start_data);
+	args.data[2].ToUnifiedFormat(count, old_end_data);
+	args.data[3].ToUnifiedFormat(count, new_end_data);
+	auto &prev_vec = args.data[4];
+	bool has_previous = prev_vec.GetType().id() == LogicalTypeId::LIST;
+	prev_vec.ToUnifiedFormat(count, prev_data);
+
+	UnifiedVectorFormat prev_pos_data, prev_len_data;
+	if (has_previous) {
+		auto prev_size = ListVector::GetListSize(prev_vec);
+		auto &fields = StructVector::GetEntries(ListVector::GetEntry(prev_vec));
+		fields[bind_data.position_idx]->ToUnifiedFormat(prev_size, prev_pos_data);
+		fields[bind_data.length_idx]->ToUnifiedFormat(prev_size, prev_len_data);
+	}
 
-static unique_ptr<FunctionData> ParseTablesBind(ClientContext &context, TableFunctionBindInput &input,
-                                                 vector<LogicalType> &return_types, vector<string> &names) {
-	auto result = make_uniq<ParseTablesBindData>();
-	string query = input.inputs[0].GetValue<string>();
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto &entries = StructVector::GetEntries(result);
+	auto start_index_data = FlatVector::GetData<int64_t>(*entries[0]);
+	auto previous_end_data = FlatVector::GetData<int64_t>(*entries[1]);
+	auto &token_list = *entries[2];
+	auto token_list_data = FlatVector::GetData<list_entry_t>(token_list);
 
-	try {
-		Parser parser;
-		parser.ParseQuery(query);
-		for (auto &stmt : parser.statements) {
-			ExtractTablesFromStatement(stmt.get(), result->tables);
+	// the query, the previous token positions and the delta are buffers reused across the rows of the chunk
+	string query;
+	vector<int64_t> prev_pos, prev_len;
+	TokensDelta delta;
+	for (idx_t i = 0; i < count; i++) {
+		auto query_idx = query_data.sel->get_index(i);
+		auto start_idx = start_data.sel->get_index(i);
+		auto old_end_idx = old_end_data.sel->get_index(i);
+		auto new_end_idx = new_end_data.sel->get_index(i);
+		auto prev_idx = prev_data.sel->get_index(i);
+		if (!has_previous || !query_data.validity.RowIsValid(query_idx) ||
+		    !start_data.validity.RowIsValid(start_idx) || !old_end_data.validity.RowIsValid(old_end_idx) ||
+		    !new_end_data.validity.RowIsValid(new_end_idx) || !prev_data.validity.RowIsValid(prev_idx)) {
+			FlatVector::SetNull(result, i, true);
+			continue;
+		}
+		auto &query_str = UnifiedVectorFormat::GetData<string_t>(query_data)[query_idx];
+		query.assign(query_str.GetData(), query_str.GetSize());
+		auto edit_start = UnifiedVectorFormat::GetData<int64_t>(start_data)[start_idx];
+		auto old_edit_end = UnifiedVectorFormat::GetData<int64_t>(old_end_data)[old_end_idx];
+		auto new_edit_end = UnifiedVectorFormat::GetData<int64_t>(new_end_data)[new_end_idx];
+		if (edit_start < 0 || old_edit_end < edit_start || new_edit_end < edit_start ||
+		    new_edit_end > static_cast<int64_t>(query.size())) {
+			throw InvalidInputException("parse_tokens_delta: invalid edit range [%d, %d) -> [%d, %d)",
+			                            edit_start, old_edit_end, edit_start, new_edit_end);
 		}
-	} catch (const Exception &e) {
-		result->error = e.what();
-	}
+
+		auto &prev_entry = UnifiedVectorFormat::GetData<list_entry_t>(prev_data)[prev_idx];
+		prev_pos.clear();
+		prev_len.clear();
+		prev_pos.reserve(prev_entry.length);
+		prev_len.reserve(prev_entry.length);
+		auto positions = UnifiedVectorFormat::GetData<int64_t>(prev_pos_data);
+		auto lengths = UnifiedVectorFormat::GetData<int64_t>(prev_len_data);
+		for (idx_t k = prev_entry.offset; k < prev_entry.offset + prev_entry.length; k++) {
+			auto pos_idx = prev_pos_data.sel->get_index(k);
+			auto len_idx = prev_len_data.sel->get_index(k);
+			if (!prev_pos_data.validity.RowIsValid(pos_idx) || !prev_len_data.validity.RowIsValid(len_idx)) {
+				throw InvalidInputException("parse_tokens_delta: previous_tokens contains NULL positions");
+			}
+			prev_pos.push_back(positions[pos_idx]);
+			prev_len.push_back(lengths[len_idx]);
+		}
+
+		ComputeTokensDelta(query, static_cast<idx_t>(edit_start), static_cast<idx_t>(old_edit_end),
+		                   static_cast<idx_t>(new_edit_end), prev_pos, prev_len, delta);
+
+		start_index_data[i] = static_cast<int64_t>(delta.start_index);
+		previous_end_data[i] = static_cast<int64_t>(delta.previous_end_index);
+		token_list_data[i] = AppendTokenList(token_list, delta.tokens);
+	}
+}
+
+// ============================================================================
+// parse_token_list(query) - the tokens of a query as a list of structs
+// ============================================================================
+
+// One query buffer and token buffer serve the whole chunk; the tokens are written straight into the struct fields
+// of the list child. The structs are those of parse_tokens_delta, so a result can be passed as its previous_tokens.
+static void ParseTokenListFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	string query_buffer;
+	vector<TokenRow> tokens;
+	UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(), [&](string_t query) {
+		query_buffer.assign(query.GetData(), query.GetSize());
+		TokenizeQuery(query_buffer, tokens);
+		return AppendTokenList(result, tokens);
+	});
+}
+
+// ============================================================================
+// Scalar functions
+// ============================================================================
+
+// The shared parse cache as seen by a scalar function: queries over the parse limits of its context are neither
+// parsed nor looked up, they give the limit error as their parse error
+class LimitedParseCache {
+public:
+	LimitedParseCache(ParseCache &cache, ParseLimits limits) : cache(cache), limits(limits) {
+	}
+
+	shared_ptr<const ParsedQuery> GetOrParse(const string_t &query) {
+		auto error = CheckLimits(query);
+		return error ? error : cache.GetOrParse(query);
+	}
+	shared_ptr<const ParsedQuery> Lookup(const string_t &query) {
+		auto error = CheckLimits(query);
+		return error ? error : cache.Lookup(query);
+	}
+	//! ValidateQuery, or the limit error
+	QueryValidation Validate(const string_t &query, bool transform = false) {
+		auto error = CheckLimits(query);
+		if (error) {
+			QueryValidation result;
+			result.error = error->error;
+			return result;
+		}
+		return ValidateQuery(query.GetString(), transform);
+	}
+
+private:
+	//! The failed parse result of a query over the limits, nullptr if it is within them
+	shared_ptr<const ParsedQuery> CheckLimits(const string_t &query) const {
+		if (!limits.IsSet()) {
+			return nullptr;
+		}
+		auto error = limits.Check(query.GetData(), query.GetSize());
+		if (error.empty()) {
+			return nullptr;
+		}
+		auto result = make_shared_ptr<ParsedQuery>();
+		result->error = ParserException(error).what();
+		return std::move(result);
+	}
+
+	ParseCache &cache;
+	ParseLimits limits;
+};
+
+// Returns the shared parse cache with the parse limits of the current settings
+static LimitedParseCache GetParseCache(ExpressionState &state) {
+	auto &context = state.GetContext();
+	return LimitedParseCache(ParseCache::Get(), GetParseLimits(context));
+}
+
+// The cache is shared by the whole process, so it takes the size set last in any connection
+static void SetParseCacheSize(ClientContext &context, SetScope scope, Value &parameter) {
+	ParseCache::Get().Resize(parameter.IsNull() ? ParseCache::DEFAULT_CAPACITY : parameter.GetValue<uint64_t>());
+}
+
+// Run a scalar function once per distinct query where the input vector makes that cheap: for a constant query on a
+// single row, giving a constant result, and for a dictionary vector with fewer entries than rows (as scanned from a
+// dictionary-compressed column) on the dictionary entries, giving a dictionary result over them. Other arguments
+// have to be constant, as they then hold for every entry.
+template <void (*FUNC)(DataChunk &args, ExpressionState &state, Vector &result)>
+static void ExecuteDistinct(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto count = args.size();
+	auto &query = args.data[0];
+	bool other_constant = true;
+	for (idx_t col = 1; col < args.ColumnCount(); col++) {
+		other_constant = other_constant && args.data[col].GetVectorType() == VectorType::CONSTANT_VECTOR;
+	}
+	if (count <= 1 || !other_constant) {
+		FUNC(args, state, result);
+		return;
+	}
+
+	DataChunk distinct_args;
+	if (query.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		distinct_args.InitializeEmpty(args.GetTypes());
+		for (idx_t col = 0; col < args.ColumnCount(); col++) {
+			distinct_args.data[col].Reference(args.data[col]);
+		}
+		distinct_args.SetCardinality(1);
+		FUNC(distinct_args, state, result);
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		return;
+	}
+	auto dictionary_size = query.GetVectorType() == VectorType::DICTIONARY_VECTOR
+	                           ? DictionaryVector::DictionarySize(query)
+	                           : optional_idx();
+	if (!dictionary_size.IsValid() || dictionary_size.GetIndex() >= count) {
+		FUNC(args, state, result);
+		return;
+	}
+	distinct_args.InitializeEmpty(args.GetTypes());
+	distinct_args.data[0].Reference(DictionaryVector::Child(query));
+	for (idx_t col = 1; col < args.ColumnCount(); col++) {
+		distinct_args.data[col].Reference(args.data[col]);
+	}
+	distinct_args.SetCardinality(dictionary_size.GetIndex());
+	FUNC(distinct_args, state, result);
+	result.Dictionary(dictionary_size.GetIndex(), DictionaryVector::SelVector(query), count);
+}
+
+// Validity and statement counts only need the grammar: answer them from the parse cache if the query was already
+// parsed, otherwise through ValidateQuery, which neither throws per invalid row nor builds the SQLStatement tree. It
+// catches mixed parameter styles, the common query the transformer rejects after the grammar accepted it.
+static void IsValidSqlFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto cache = GetParseCache(state);
+	UnaryExecutor::Execute<string_t, bool>(args.data[0], result, args.size(), [&](string_t query) {
+		auto parsed = cache.Lookup(query);
+		if (parsed) {
+			return parsed->success;
+		}
+		return cache.Validate(query).success;
+	});
+}
+
+// The error message is the one of the full parse: on a cache miss the grammar result is transformed like
+// Parser::ParseQuery does, without running the grammar again
+
+static void SqlErrorMessageFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto cache = GetParseCache(state);
+	auto &input = args.data[0];
+	auto count = args.size();
+
+	UnifiedVectorFormat vdata;
+	input.ToUnifiedFormat(count, vdata);
+	auto input_data = UnifiedVectorFormat::GetData<string_t>(vdata);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<string_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		if (!vdata.validity.RowIsValid(idx)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+
+		auto parsed = cache.Lookup(input_data[idx]);
+		auto validation = parsed ? QueryValidation() : cache.Validate(input_data[idx], true);
+		auto &error = parsed ? parsed->error : validation.error;
+		if (parsed ? parsed->success : validation.success) {
+			// Valid SQL - return NULL
+			result_validity.SetInvalid(i);
+		} else {
+			result_data[i] = StringVector::AddString(result, error);
+		}
+	}
+}
+
+static void SqlErrorPositionFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto cache = GetParseCache(state);
+	UnaryExecutor::ExecuteWithNulls<string_t, int64_t>(
+	    args.data[0], result, args.size(), [&](string_t query, ValidityMask &mask, idx_t idx) {
+		    auto validation = cache.Validate(query);
+		    if (validation.success || !validation.error_location.IsValid()) {
+			    mask.SetInvalid(idx);
+			    return static_cast<int64_t>(0);
+		    }
+		    return static_cast<int64_t>(validation.error_location.GetIndex());
+	    });
+}
+
+static void NumStatementsFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto cache = GetParseCache(state);
+	UnaryExecutor::Execute<string_t, int64_t>(args.data[0], result, args.size(), [&](string_t query) {
+		auto parsed = cache.Lookup(query);
+		if (parsed) {
+			return parsed->success ? static_cast<int64_t>(parsed->statements.size()) : static_cast<int64_t>(0);
+		}
+		auto validation = cache.Validate(query);
+		return validation.success ? static_cast<int64_t>(validation.statement_count) : static_cast<int64_t>(0);
+	});
+}
+
+// The keywords of the grammar with their categories, built once. Lookups hash the (ASCII lower-cased) bytes of a
+// string_t into an open-addressing table at most a quarter full, so they neither allocate nor probe far.
+class KeywordTable {
+public:
+	static const KeywordTable &Get() {
+		static const KeywordTable table;
+		return table;
+	}
+
+	//! The keyword str is (case-insensitively), or nullptr
+	const ParserKeyword *Find(string_t str) const {
+		auto size = str.GetSize();
+		if (size == 0 || size > max_length) {
+			return nullptr;
+		}
+		char lower[MAX_KEYWORD_LENGTH];
+		auto data = str.GetData();
+		for (idx_t i = 0; i < size; i++) {
+			lower[i] = StringUtil::CharacterToLower(data[i]);
+		}
+		for (auto slot = Hash(lower, size) & mask;; slot = (slot + 1) & mask) {
+			if (slots[slot] == 0) {
+				return nullptr;
+			}
+			auto &keyword = keywords[slots[slot] - 1];
+			if (keyword.name.size() == size && memcmp(keyword.name.data(), lower, size) == 0) {
+				return &keyword;
+			}
+		}
+	}
+
+	//! All keywords as a LIST(VARCHAR) value
+	const Value &KeywordNames() const {
+		return keyword_names;
+	}
+	const vector<ParserKeyword> &Keywords() const {
+		return keywords;
+	}
+
+private:
+	static constexpr idx_t MAX_KEYWORD_LENGTH = 64;
+
+	KeywordTable() : keywords(Parser::KeywordList()) {
+		idx_t capacity = 16;
+		while (capacity < keywords.size() * 4) {
+			capacity *= 2;
+		}
+		slots.resize(capacity, 0);
+		mask = capacity - 1;
+		vector<Value> names;
+		for (idx_t i = 0; i < keywords.size(); i++) {
+			auto &name = keywords[i].name;
+			names.emplace_back(name);
+			if (name.size() > MAX_KEYWORD_LENGTH) {
+				continue;
+			}
+			max_length = MaxValue(max_length, name.size());
+			auto slot = Hash(name.data(), name.size()) & mask;
+			while (slots[slot] != 0) {
+				slot = (slot + 1) & mask;
+			}
+			slots[slot] = NumericCast<uint32_t>(i + 1);
+		}
+		keyword_names = Value::LIST(LogicalType::VARCHAR, std::move(names));
+	}
+
+	// FNV-1a
+	static uint64_t Hash(const char *data, idx_t size) {
+		uint64_t hash = 14695981039346656037ULL;
+		for (idx_t i = 0; i < size; i++) {
+			hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	vector<ParserKeyword> keywords;
+	//! Index + 1 into keywords, 0 for an empty slot
+	vector<uint32_t> slots;
+	uint64_t mask;
+	idx_t max_length = 0;
+	Value keyword_names;
+};
+
+static const char *KeywordCategoryName(KeywordCategory category) {
+	switch (category) {
+	case KeywordCategory::KEYWORD_RESERVED:
+		return "reserved";
+	case KeywordCategory::KEYWORD_UNRESERVED:
+		return "unreserved";
+	case KeywordCategory::KEYWORD_TYPE_FUNC:
+		return "type_func";
+	case KeywordCategory::KEYWORD_COL_NAME:
+		return "col_name";
+	default:
+		return nullptr;
+	}
+}
+
+static void IsKeywordFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &keywords = KeywordTable::Get();
+	UnaryExecutor::Execute<string_t, bool>(args.data[0], result, args.size(),
+	                                       [&](string_t str) { return keywords.Find(str) != nullptr; });
+}
+
+// keyword_category(str) - reserved, unreserved, type_func or col_name; NULL if str is not a keyword
+static void KeywordCategoryFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &keywords = KeywordTable::Get();
+	UnaryExecutor::ExecuteWithNulls<string_t, string_t>(args.data[0], result, args.size(),
+	                                                    [&](string_t str, ValidityMask &mask, idx_t idx) {
+		                                                    auto keyword = keywords.Find(str);
+		                                                    auto name = keyword ? KeywordCategoryName(keyword->category)
+		                                                                        : nullptr;
+		                                                    if (!name) {
+			                                                    mask.SetInvalid(idx);
+			                                                    return string_t();
+		                                                    }
+		                                                    return string_t(name);
+	                                                    });
+}
+
+// ============================================================================
+// sql_keywords() - list all SQL keywords
+// ============================================================================
+
+struct SqlKeywordsBindData : public TableFunctionData {
+	const vector<ParserKeyword> *keywords;
+};
+
+struct SqlKeywordsState : public GlobalTableFunctionState {
+	idx_t current_idx = 0;
+};
+
+static unique_ptr<FunctionData> SqlKeywordsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<SqlKeywordsBindData>();
+	result->keywords = &KeywordTable::Get().Keywords();
 
 	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("schema_name");
-	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("table_name");
+	names.push_back("keyword");
 	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("context");
+	names.push_back("category");
 
 	return std::move(result);
 }
 
-static unique_ptr<GlobalTableFunctionState> ParseTablesInit(ClientContext &context, TableFunctionInitInput &input) {
-	return make_uniq<ParseTablesState>();
+static unique_ptr<GlobalTableFunctionState> SqlKeywordsInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<SqlKeywordsState>();
 }
 
-static void ParseTablesFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
-	auto &bind_data = data_p.bind_data->Cast<ParseTablesBindData>();
-	auto &state = data_p.global_state->Cast<ParseTablesState>();
+static void SqlKeywordsFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &bind_data = data_p.bind_data->Cast<SqlKeywordsBindData>();
+	auto &state = data_p.global_state->Cast<SqlKeywordsState>();
 
+	auto &keywords = *bind_data.keywords;
 	idx_t count = 0;
-	while (state.current_idx < bind_data.tables.size() && count < STANDARD_VECTOR_SIZE) {
-		auto &t = bind_data.tables[state.current_idx];
-		output.data[0].SetValue(count, t.schema.empty() ? Value() : Value(t.schema));
-		output.data[1].SetValue(count, Value(t.table));
-		output.data[2].SetValue(count, Value(t.context));
+	while (state.current_idx < keywords.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &keyword = keywords[state.current_idx];
+		FlatVector::GetData<string_t>(output.data[0])[count] = StringVector::AddString(output.data[0], keyword.name);
+		auto category = KeywordCategoryName(keyword.category);
+		if (category) {
+			FlatVector::GetData<string_t>(output.data[1])[count] = string_t(category);
+		} else {
+			FlatVector::SetNull(output.data[1], count, true);
+		}
 		count++;
 		state.current_idx++;
 	}
@@ -433,639 +1165,2810 @@ static void ParseTablesFunc(ClientContext &context, TableFunctionInput &data_p,
 }
 
 // ============================================================================
-// parse_table_names(query) - Returns table names as array
+// parse_keyword_names() - Returns keyword names as array
+// ============================================================================
+
+// The list is built once; every chunk references it as a constant
+static void ParseKeywordNamesFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	result.Reference(KeywordTable::Get().KeywordNames());
+}
+
+// ============================================================================
+// parse_statements(query) - parse multi-statement SQL
+// ============================================================================
+
+struct StatementRow {
+	idx_t stmt_index;
+	string stmt_type; // empty when the statement failed to parse
+	string error;
+	idx_t param_count;
+	SourceSpan span;
+};
+
+// A script is split into statements with the tokenizer, which is much cheaper than parsing, and the statements are
+// then parsed in segments of roughly PARSE_SEGMENT_SIZE bytes, in parallel for a constant script. A statement's index
+// is its position in the script, so the segments can be parsed in any order. Nothing is done at bind time: a
+// constant script is split when the scan starts and a segment is parsed when a thread claims it, so a LIMIT ends the
+// scan without parsing the rest of the script.
+
+static constexpr idx_t PARSE_SEGMENT_SIZE = 256 * 1024;
+
+//! Byte range [start, end) of one statement, excluding its terminating ';'
+struct StatementPiece {
+	idx_t start;
+	idx_t end;
+	//! Start of the first token, i.e. where the statement text begins after whitespace and comments
+	idx_t first_token;
+};
+
+//! Range [begin, end) of statement pieces parsed as one unit
+struct StatementSegment {
+	idx_t begin;
+	idx_t end;
+};
+
+static bool StripSqlComments(const char *data, idx_t size, string &output);
+
+// Whether text has anything but whitespace and comments
+static bool HasStatementText(const char *data, idx_t size) {
+	string stripped;
+	if (StripSqlComments(data, size, stripped)) {
+		data = stripped.data();
+		size = stripped.size();
+	}
+	for (idx_t i = 0; i < size; i++) {
+		if (!StringUtil::CharacterIsSpace(data[i])) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Split a script at the ';' tokens into its non-empty statements. If the script is not complete (it continues
+// beyond the text), the text after the last ';' is left out; returns the offset where that unsplit rest starts.
+static idx_t SplitStatements(const string &query, vector<StatementPiece> &pieces, bool complete = true) {
+	if (!memchr(query.data(), ';', query.size())) {
+		// the common single statement without a ';' byte needs no tokenizer pass, which costs about as much as
+		// parsing a short query
+		if (!complete) {
+			return 0;
+		}
+		auto first_token = SkipSpaceAndComments(query.data(), 0, query.size());
+		if (first_token < query.size()) {
+			pieces.push_back(StatementPiece {0, query.size(), first_token});
+		}
+		return query.size();
+	}
+	auto tokens = TokenizeTimed(query);
+	idx_t piece_start = 0;
+	optional_idx first_token;
+	for (auto &token : tokens) {
+		if (query[token.start] == ';') {
+			if (first_token.IsValid()) {
+				pieces.push_back(StatementPiece {piece_start, token.start, first_token.GetIndex()});
+			}
+			piece_start = token.start + 1;
+			first_token = optional_idx();
+		} else if (token.type != SimplifiedTokenType::SIMPLIFIED_TOKEN_COMMENT && !first_token.IsValid()) {
+			first_token = token.start;
+		}
+	}
+	if (!complete) {
+		return piece_start;
+	}
+	// the tokenizer stops at a lexer error (e.g. an unterminated string), keep the rest so its error is reported
+	if (first_token.IsValid() || HasStatementText(query.data() + piece_start, query.size() - piece_start)) {
+		auto start = first_token.IsValid() ? first_token.GetIndex() : piece_start;
+		pieces.push_back(StatementPiece {piece_start, query.size(), start});
+	}
+	return query.size();
+}
+
+// Group consecutive pieces into segments of at least PARSE_SEGMENT_SIZE bytes
+static void SplitSegments(const vector<StatementPiece> &pieces, vector<StatementSegment> &segments) {
+	idx_t begin = 0;
+	for (idx_t i = 0; i < pieces.size(); i++) {
+		if (pieces[i].end - pieces[begin].start >= PARSE_SEGMENT_SIZE || i + 1 == pieces.size()) {
+			segments.push_back(StatementSegment {begin, i + 1});
+			begin = i + 1;
+		}
+	}
+}
+
+// Parse pieces [begin, end) of query, calling callback(piece_idx, statement, error, text_start) for every statement,
+// with a null statement for a piece that does not parse. text_start is the offset in query of the text the statement
+// was parsed from, which its AST locations are relative to. The pieces are parsed together; if that fails they are
+// parsed one by one, so that only the statements that do not parse are reported as errors.
+template <class CALLBACK>
+static void ParseStatementRun(const string &query, const vector<StatementPiece> &pieces, idx_t begin, idx_t end,
+                              CALLBACK &callback) {
+	if (begin >= end) {
+		return;
+	}
+	auto start = pieces[begin].start;
+	try {
+		ParserLease lease;
+		auto &text = lease.GetText();
+		text.assign(query, start, pieces[end - 1].end - start);
+		auto &parser = lease.GetParser();
+		ParseQueryTimed(parser, text);
+		if (end - begin == 1 || parser.statements.size() == end - begin) {
+			for (idx_t i = 0; i < parser.statements.size(); i++) {
+				callback(end - begin == 1 ? begin : begin + i, parser.statements[i].get(), string(), start);
+			}
+			return;
+		}
+	} catch (const Exception &e) {
+		PoachedStats::Add(PoachedStat::EXCEPTIONS);
+		if (end - begin == 1) {
+			callback(begin, nullptr, string(e.what()), start);
+			return;
+		}
+	}
+	for (idx_t i = begin; i < end; i++) {
+		ParseStatementRun(query, pieces, i, i + 1, callback);
+	}
+}
+
+// ParseStatementRun with the parse limits, which hold per statement: a piece over them is reported as an error
+// without being parsed, the runs of pieces between those are parsed together
+template <class CALLBACK>
+static void ParseStatementPieces(const string &query, const vector<StatementPiece> &pieces, idx_t begin, idx_t end,
+                                 const ParseLimits &limits, CALLBACK &&callback) {
+	if (!limits.IsSet()) {
+		ParseStatementRun(query, pieces, begin, end, callback);
+		return;
+	}
+	auto run_begin = begin;
+	for (idx_t i = begin; i < end; i++) {
+		auto &piece = pieces[i];
+		auto error = limits.Check(query.data() + piece.start, piece.end - piece.start);
+		if (error.empty()) {
+			continue;
+		}
+		ParseStatementRun(query, pieces, run_begin, i, callback);
+		callback(i, nullptr, string(ParserException(error).what()), piece.start);
+		run_begin = i + 1;
+	}
+	ParseStatementRun(query, pieces, run_begin, end, callback);
+}
+
+// Span of a statement, from its first token to the end of its last, without the terminating ';' or trailing
+// whitespace and comments
+static SourceSpan StatementSpan(const string &query, const StatementPiece &piece, const LineIndex &lines) {
+	SourceSpan span;
+	span.start_byte = piece.first_token;
+	span.end_byte = TokenTextEnd(query.data(), piece.first_token, MaxValue(piece.end, piece.first_token));
+	lines.Locate(span);
+	return span;
+}
+
+// Number of distinct parameters ($1, $name or ?) of a statement
+static idx_t StatementParamCount(const SQLStatement &stmt) {
+	return stmt.named_param_map.size();
+}
+
+// Parse pieces [begin, end) of query into one row per statement whose type the filter of bind_data accepts; a
+// statement that does not parse has a NULL type, which no pushed-down filter accepts. The spans are only located with
+// lines, and the error messages only kept with keep_errors, for when those columns are projected.
+static void ParseStatementRows(const ParseFunctionData &bind_data, const string &query,
+                               const vector<StatementPiece> &pieces, idx_t begin, idx_t end, const LineIndex *lines,
+                               bool keep_errors, vector<StatementRow> &rows) {
+	auto &stmt_types = bind_data.filter;
+	ParseStatementPieces(query, pieces, begin, end, bind_data.limits,
+	                     [&](idx_t piece_idx, SQLStatement *stmt, const string &error, idx_t text_start) {
+		                     auto stmt_type = stmt ? StatementTypeToString(stmt->type) : string();
+		                     if (stmt_types.IsRestricted() && (!stmt || !stmt_types.Accepts(stmt_type))) {
+			                     return;
+		                     }
+		                     rows.push_back(StatementRow {
+		                         piece_idx, std::move(stmt_type), keep_errors ? error : string(),
+		                         stmt ? StatementParamCount(*stmt) : 0,
+		                         lines ? StatementSpan(query, pieces[piece_idx], *lines) : SourceSpan()});
+	                     });
+}
+
+static constexpr idx_t STATEMENT_TYPE_COLUMN = 1;
+static constexpr idx_t STATEMENT_ERROR_COLUMN = 2;
+static constexpr idx_t STATEMENT_SPAN_COLUMN = 4;
+
+// Parse a (multi-statement) query into one row per statement
+static void ParseStatementsCollect(const ParseFunctionData &bind_data, const string &query,
+                                   const ColumnProjection &projection, vector<StatementRow> &rows) {
+	vector<StatementPiece> pieces;
+	SplitStatements(query, pieces);
+	unique_ptr<LineIndex> lines;
+	if (ProjectsSpan(projection, STATEMENT_SPAN_COLUMN)) {
+		lines = make_uniq<LineIndex>(query);
+	}
+	ParseStatementRows(bind_data, query, pieces, 0, pieces.size(), lines.get(),
+	                   projection.Contains(STATEMENT_ERROR_COLUMN), rows);
+}
+
+static void WriteStatementRow(DataChunk &output, const ColumnProjection &projection, idx_t out_idx,
+                              const StatementRow &row) {
+	for (idx_t col_idx = 0; col_idx < projection.columns.size(); col_idx++) {
+		auto &vector = output.data[col_idx];
+		switch (projection.columns[col_idx]) {
+		case 0:
+			vector.SetValue(out_idx, Value::BIGINT(row.stmt_index));
+			break;
+		case STATEMENT_TYPE_COLUMN:
+			vector.SetValue(out_idx, row.stmt_type.empty() ? Value() : Value(row.stmt_type));
+			break;
+		case STATEMENT_ERROR_COLUMN:
+			vector.SetValue(out_idx, row.error.empty() ? Value() : Value(row.error));
+			break;
+		case 3:
+			// the parameters of a statement that does not parse are unknown
+			vector.SetValue(out_idx, row.stmt_type.empty() ? Value() : Value::BIGINT(row.param_count));
+			break;
+		default:
+			WriteSpanField(vector, projection.columns[col_idx] - STATEMENT_SPAN_COLUMN, out_idx, row.span);
+			break;
+		}
+	}
+}
+
+struct ParseStatementsBindData : public ParseFunctionData {
+	string query;
+};
+
+//! The script split into segments, shared by the scan threads
+struct ParseStatementsState : public GlobalTableFunctionState {
+	ParseStatementsState(const string &query, const vector<column_t> &column_ids) : projection(column_ids) {
+		SplitStatements(query, pieces);
+		SplitSegments(pieces, segments);
+		if (ProjectsSpan(projection, STATEMENT_SPAN_COLUMN)) {
+			lines = make_uniq<LineIndex>(query);
+		}
+	}
+
+	ColumnProjection projection;
+	vector<StatementPiece> pieces;
+	vector<StatementSegment> segments;
+	//! Only built if a span column is projected
+	unique_ptr<LineIndex> lines;
+	std::atomic<idx_t> next_segment {0};
+
+	idx_t MaxThreads() const override {
+		return MaxValue<idx_t>(segments.size(), 1);
+	}
+};
+
+//! Scan state of one thread; also serves as the in-out state when parsing a column of scripts
+struct ParseStatementsLocalState : public ParseInOutState<StatementRow> {
+	explicit ParseStatementsLocalState(const vector<column_t> &column_ids) : ParseInOutState(column_ids) {
+	}
+
+	//! The segment the rows belong to, reported as batch index so that the statement order is kept
+	idx_t segment_idx = 0;
+};
+
+static unique_ptr<FunctionData> ParseStatementsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<ParseStatementsBindData>();
+	result->limits = GetParseLimits(context);
+	if (!input.inputs.empty()) {
+		result->query = input.inputs[0].GetValue<string>();
+	}
+
+	return_types.push_back(LogicalType::BIGINT);
+	names.push_back("stmt_index");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("stmt_type");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("error");
+	return_types.push_back(LogicalType::BIGINT);
+	names.push_back("param_count");
+	AddSpanColumns(return_types, names);
+
+	return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ParseStatementsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<ParseStatementsBindData>();
+	return make_uniq<ParseStatementsState>(bind_data.query, input.column_ids);
+}
+
+static unique_ptr<LocalTableFunctionState> ParseStatementsInitLocal(ExecutionContext &context,
+                                                                    TableFunctionInitInput &input,
+                                                                    GlobalTableFunctionState *global_state) {
+	return make_uniq<ParseStatementsLocalState>(input.column_ids);
+}
+
+static void ParseStatementsFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &bind_data = data_p.bind_data->Cast<ParseStatementsBindData>();
+	auto &state = data_p.global_state->Cast<ParseStatementsState>();
+	auto &local_state = data_p.local_state->Cast<ParseStatementsLocalState>();
+
+	// a chunk only holds rows of one segment, claim the next segment once the current one is emitted
+	while (local_state.row_idx >= local_state.rows.size()) {
+		local_state.rows.clear();
+		local_state.row_idx = 0;
+		auto segment_idx = state.next_segment++;
+		if (segment_idx >= state.segments.size()) {
+			output.SetCardinality(0);
+			return;
+		}
+		local_state.segment_idx = segment_idx;
+		auto &segment = state.segments[segment_idx];
+		ParseStatementRows(bind_data, bind_data.query, state.pieces, segment.begin, segment.end, state.lines.get(),
+		                   state.projection.Contains(STATEMENT_ERROR_COLUMN), local_state.rows);
+	}
+
+	idx_t count = 0;
+	while (local_state.row_idx < local_state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		WriteStatementRow(output, state.projection, count++, local_state.rows[local_state.row_idx++]);
+	}
+	output.SetCardinality(count);
+}
+
+static OperatorPartitionData ParseStatementsGetPartitionData(ClientContext &context,
+                                                             TableFunctionGetPartitionInput &input) {
+	if (input.partition_info.RequiresPartitionColumns()) {
+		throw InternalException("parse_statements: partition columns are not supported");
+	}
+	auto &local_state = input.local_state->Cast<ParseStatementsLocalState>();
+	return OperatorPartitionData(local_state.segment_idx);
+}
+
+static void ParseStatementsInOutCollect(const FunctionData &bind_data, const ColumnProjection &projection,
+                                        DataChunk &input, const UnifiedVectorFormat &query_data, idx_t row_idx,
+                                        vector<StatementRow> &rows) {
+	string query;
+	if (GetInOutString(query_data, row_idx, query)) {
+		ParseStatementsCollect(bind_data.Cast<ParseFunctionData>(), query, projection, rows);
+	}
+}
+
+// ============================================================================
+// Statement-wise extraction, shared by parse_tables, parse_functions, parse_where, parse_columns, parse_lineage and
+// parse_parameters
+// ============================================================================
+//
+// The extractors do no work at bind time. A constant query is split into statements when the scan starts, and a
+// statement is only parsed once the rows of the statements before it have been emitted, so a LIMIT ends the scan
+// without parsing the rest of the query. Each statement is parsed on its own, so one that does not parse has no rows
+// but does not hide the rows of the others.
+
+//! Bind data of an extractor: the constant query, empty when the function runs as an in-out function
+struct ParseQueryBindData : public ParseFunctionData {
+	string query;
+};
+
+template <class ROW>
+struct ParseQueryScanState : public GlobalTableFunctionState {
+	ParseQueryScanState(const string &query, const vector<column_t> &column_ids)
+	    : projection(column_ids), spans(query) {
+		SplitStatements(query, pieces);
+		end_piece = pieces.size();
+	}
+
+	ColumnProjection projection;
+	vector<StatementPiece> pieces;
+	//! The next piece to parse, and the end of the pieces to scan
+	idx_t next_piece = 0;
+	idx_t end_piece;
+	SpanLocator spans;
+	//! Rows of the last parsed statement not emitted yet
+	vector<ROW> rows;
+	idx_t row_idx = 0;
+};
+
+// Parse pieces [begin, end) of query and EXTRACT the rows of every statement that parses, given its index in the
+// query. EXTRACT only fills in the fields of the projected columns, and only locates spans if a span column is
+// projected.
+template <class ROW,
+          void (*EXTRACT)(const FunctionData &bind_data, const ColumnProjection &projection, SQLStatement &stmt,
+                          idx_t stmt_index, SpanLocator &spans, vector<ROW> &rows)>
+static void ExtractStatementRows(const FunctionData &bind_data, const ColumnProjection &projection,
+                                 const string &query, const vector<StatementPiece> &pieces, idx_t begin, idx_t end,
+                                 SpanLocator &spans, vector<ROW> &rows) {
+	ParseStatementPieces(query, pieces, begin, end, bind_data.Cast<ParseFunctionData>().limits,
+	                     [&](idx_t piece_idx, SQLStatement *stmt, const string &error, idx_t text_start) {
+		                     if (stmt) {
+			                     spans.SetBase(text_start);
+			                     EXTRACT(bind_data, projection, *stmt, piece_idx, spans, rows);
+		                     }
+	                     });
+}
+
+template <class ROW>
+static unique_ptr<GlobalTableFunctionState> ParseQueryScanInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<ParseQueryScanState<ROW>>(input.bind_data->Cast<ParseQueryBindData>().query, input.column_ids);
+}
+
+// Fill the chunk with the rows of the next statements, parsing one statement at a time
+template <class ROW,
+          void (*EXTRACT)(const FunctionData &bind_data, const ColumnProjection &projection, SQLStatement &stmt,
+                          idx_t stmt_index, SpanLocator &spans, vector<ROW> &rows),
+          void (*WRITE)(DataChunk &output, const ColumnProjection &projection, idx_t out_idx, const ROW &row)>
+static void ParseQueryScanFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &bind_data = data_p.bind_data->Cast<ParseQueryBindData>();
+	auto &state = data_p.global_state->Cast<ParseQueryScanState<ROW>>();
+
+	idx_t count = 0;
+	while (count < STANDARD_VECTOR_SIZE) {
+		if (state.row_idx >= state.rows.size()) {
+			if (state.next_piece >= state.end_piece) {
+				break;
+			}
+			state.rows.clear();
+			state.row_idx = 0;
+			auto piece_idx = state.next_piece++;
+			ExtractStatementRows<ROW, EXTRACT>(bind_data, state.projection, bind_data.query, state.pieces, piece_idx,
+			                                   piece_idx + 1, state.spans, state.rows);
+			continue;
+		}
+		WRITE(output, state.projection, count++, state.rows[state.row_idx++]);
+	}
+	output.SetCardinality(count);
+}
+
+// Split and parse a query of an input row, all statements at once, and EXTRACT the rows of its statements
+template <class ROW,
+          void (*EXTRACT)(const FunctionData &bind_data, const ColumnProjection &projection, SQLStatement &stmt,
+                          idx_t stmt_index, SpanLocator &spans, vector<ROW> &rows)>
+static void ParseQueryInOutCollect(const FunctionData &bind_data, const ColumnProjection &projection,
+                                   DataChunk &input, const UnifiedVectorFormat &query_data, idx_t row_idx,
+                                   vector<ROW> &rows) {
+	string query;
+	if (GetInOutString(query_data, row_idx, query)) {
+		vector<StatementPiece> pieces;
+		SplitStatements(query, pieces);
+		SpanLocator spans(query);
+		ExtractStatementRows<ROW, EXTRACT>(bind_data, projection, query, pieces, 0, pieces.size(), spans, rows);
+	}
+}
+
+// ============================================================================
+// parse_tables(query) - Extract table references
+// ============================================================================
+
+static constexpr idx_t TABLE_CONTEXT_COLUMN = 2;
+static constexpr idx_t TABLE_SPAN_COLUMN = 3;
+
+static void ExtractTables(const FunctionData &bind_data, const ColumnProjection &projection, SQLStatement &stmt,
+                          idx_t stmt_index, SpanLocator &spans, vector<ExtractedTable> &tables) {
+	QueryAnalysis analysis;
+	auto table_spans = ProjectsSpan(projection, TABLE_SPAN_COLUMN) ? &spans : nullptr;
+	QueryAnalyzer analyzer(analysis, AnalysisTarget::TABLES, table_spans);
+	analyzer.SetTableContexts(bind_data.Cast<ParseFunctionData>().filter);
+	analyzer.VisitStatement(stmt);
+	tables.insert(tables.end(), analysis.tables.begin(), analysis.tables.end());
+}
+
+static void WriteTableRow(DataChunk &output, const ColumnProjection &projection, idx_t out_idx,
+                          const ExtractedTable &t) {
+	for (idx_t col_idx = 0; col_idx < projection.columns.size(); col_idx++) {
+		auto &vector = output.data[col_idx];
+		switch (projection.columns[col_idx]) {
+		case 0:
+			vector.SetValue(out_idx, t.schema.empty() ? Value() : Value(t.schema));
+			break;
+		case 1:
+			vector.SetValue(out_idx, Value(t.table));
+			break;
+		case TABLE_CONTEXT_COLUMN:
+			vector.SetValue(out_idx, Value(t.context));
+			break;
+		default:
+			WriteSpanField(vector, projection.columns[col_idx] - TABLE_SPAN_COLUMN, out_idx, t.span);
+			break;
+		}
+	}
+}
+
+static unique_ptr<FunctionData> ParseTablesBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<ParseQueryBindData>();
+	result->limits = GetParseLimits(context);
+	if (!input.inputs.empty()) {
+		result->query = input.inputs[0].GetValue<string>();
+	}
+
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("schema_name");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("table_name");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("context");
+	AddSpanColumns(return_types, names);
+
+	return std::move(result);
+}
+
+// ============================================================================
+// parse_table_names(query) - Returns table names as array
+// ============================================================================
+
+// Appends the names of a row to a LIST(VARCHAR) result, copying them from the AST straight into the string heap of
+// the child vector
+class ListNameWriter : public NameSink {
+public:
+	explicit ListNameWriter(Vector &list) : list(list) {
+	}
+
+	//! Start the list of the next row
+	void Begin() {
+		start = ListVector::GetListSize(list);
+	}
+	void AddName(const string &name) override {
+		auto size = ListVector::GetListSize(list);
+		ListVector::Reserve(list, size + 1);
+		auto &child = ListVector::GetEntry(list);
+		FlatVector::GetData<string_t>(child)[size] = StringVector::AddString(child, name);
+		ListVector::SetListSize(list, size + 1);
+	}
+	void AddNull() {
+		auto size = ListVector::GetListSize(list);
+		ListVector::Reserve(list, size + 1);
+		FlatVector::SetNull(ListVector::GetEntry(list), size, true);
+		ListVector::SetListSize(list, size + 1);
+	}
+	//! The list of the row started by Begin
+	list_entry_t End() const {
+		return list_entry_t {start, ListVector::GetListSize(list) - start};
+	}
+
+private:
+	Vector &list;
+	idx_t start = 0;
+};
+
+static void ParseTableNamesFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto cache = GetParseCache(state);
+	ListNameWriter writer(result);
+	UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(), [&](string_t query) {
+		auto parsed = cache.GetOrParse(query);
+		writer.Begin();
+		AnalyzeNames(parsed->statements, AnalysisTarget::TABLES, writer);
+		return writer.End();
+	});
+}
+
+// ============================================================================
+// parse_statement_types(query) - Returns statement types as array
+// ============================================================================
+//
+// Most statements are told apart by their first keyword, so classifying them needs no parse: skip whitespace and
+// comments to the first token, look the word up in a perfect hash of the statement keywords, and take the type the
+// keyword stands for. Only statements the first keyword does not decide (WITH, a parenthesized query, SHOW,
+// COPY FROM DATABASE, PRAGMA, which is a SET when it assigns a value, ...) are parsed. Without a parse the statements
+// are not checked for syntax errors.
+
+//! A keyword that decides the type of the statement it starts
+struct StatementKeyword {
+	const char *keyword;
+	StatementType type;
+	//! The statement is parsed instead if this word follows the keyword, e.g. UPDATE EXTENSIONS
+	const char *unless_followed_by;
+};
+
+static const StatementKeyword STATEMENT_KEYWORDS[] = {
+    {"select", StatementType::SELECT_STATEMENT, nullptr},
+    {"values", StatementType::SELECT_STATEMENT, nullptr},
+    {"from", StatementType::SELECT_STATEMENT, nullptr},
+    {"insert", StatementType::INSERT_STATEMENT, nullptr},
+    {"update", StatementType::UPDATE_STATEMENT, "extensions"},
+    {"delete", StatementType::DELETE_STATEMENT, nullptr},
+    {"create", StatementType::CREATE_STATEMENT, nullptr},
+    {"drop", StatementType::DROP_STATEMENT, nullptr},
+    {"alter", StatementType::ALTER_STATEMENT, nullptr},
+    {"begin", StatementType::TRANSACTION_STATEMENT, nullptr},
+    {"start", StatementType::TRANSACTION_STATEMENT, nullptr},
+    {"commit", StatementType::TRANSACTION_STATEMENT, nullptr},
+    {"end", StatementType::TRANSACTION_STATEMENT, nullptr},
+    {"rollback", StatementType::TRANSACTION_STATEMENT, nullptr},
+    {"abort", StatementType::TRANSACTION_STATEMENT, nullptr},
+    {"copy", StatementType::COPY_STATEMENT, "from"},
+    {"explain", StatementType::EXPLAIN_STATEMENT, nullptr},
+    {"set", StatementType::SET_STATEMENT, nullptr},
+    {"reset", StatementType::SET_STATEMENT, nullptr},
+    {"call", StatementType::CALL_STATEMENT, nullptr},
+    {"load", StatementType::LOAD_STATEMENT, nullptr},
+    {"attach", StatementType::ATTACH_STATEMENT, nullptr},
+    {"detach", StatementType::DETACH_STATEMENT, nullptr},
+    {"export", StatementType::EXPORT_STATEMENT, nullptr},
+    {"prepare", StatementType::PREPARE_STATEMENT, nullptr},
+    {"execute", StatementType::EXECUTE_STATEMENT, nullptr},
+    {"vacuum", StatementType::VACUUM_STATEMENT, nullptr}};
+
+// The statement keywords that are keywords of the grammar, in a table where each has a slot of its own: a lookup is
+// one hash and at most one compare
+class StatementKeywordTable {
+public:
+	static const StatementKeywordTable &Get() {
+		static const StatementKeywordTable table;
+		return table;
+	}
+
+	//! The statement keyword word is (case-insensitively), or nullptr
+	const StatementKeyword *Find(const char *data, idx_t size) const {
+		if (size == 0 || size > MAX_LENGTH) {
+			return nullptr;
+		}
+		char lower[MAX_LENGTH];
+		for (idx_t i = 0; i < size; i++) {
+			lower[i] = StringUtil::CharacterToLower(data[i]);
+		}
+		auto entry = slots[Hash(lower, size, seed) & (SLOT_COUNT - 1)];
+		if (!entry || entry->keyword[size] != '\0' || memcmp(entry->keyword, lower, size) != 0) {
+			return nullptr;
+		}
+		return entry;
+	}
+
+private:
+	//! The longest statement keyword, "rollback"
+	static constexpr idx_t MAX_LENGTH = 8;
+	static constexpr idx_t SLOT_COUNT = 256;
+
+	StatementKeywordTable() {
+		auto &keywords = KeywordTable::Get();
+		vector<const StatementKeyword *> entries;
+		for (auto &entry : STATEMENT_KEYWORDS) {
+			if (keywords.Find(string_t(entry.keyword))) {
+				entries.push_back(&entry);
+			}
+		}
+		// try seeds until no two keywords share a slot, a few dozen at most for a table this sparse
+		for (seed = 0;; seed++) {
+			if (seed == NumericLimits<uint32_t>::Maximum()) {
+				throw InternalException("no perfect hash for the statement keywords");
+			}
+			for (auto &slot : slots) {
+				slot = nullptr;
+			}
+			bool collision = false;
+			for (auto entry : entries) {
+				auto &slot = slots[Hash(entry->keyword, strlen(entry->keyword), seed) & (SLOT_COUNT - 1)];
+				collision = collision || slot;
+				slot = entry;
+			}
+			if (!collision) {
+				break;
+			}
+		}
+	}
+
+	// FNV-1a, offset by the seed
+	static uint64_t Hash(const char *data, idx_t size, uint32_t seed) {
+		uint64_t hash = 14695981039346656037ULL ^ seed;
+		for (idx_t i = 0; i < size; i++) {
+			hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ULL;
+		}
+		return hash ^ (hash >> 32);
+	}
+
+	const StatementKeyword *slots[SLOT_COUNT];
+	uint32_t seed;
+};
+
+// The end of the word starting at pos: letters, digits, '_' and non-ASCII bytes, as in an identifier
+static idx_t WordEnd(const char *data, idx_t pos, idx_t size) {
+	while (pos < size) {
+		auto c = static_cast<unsigned char>(data[pos]);
+		if (!StringUtil::CharacterIsAlphaNumeric(static_cast<char>(c)) && c != '_' && c < 0x80) {
+			break;
+		}
+		pos++;
+	}
+	return pos;
+}
+
+// The type of the statement whose first token is at first_token and which ends at end, as told by its first keyword;
+// INVALID_STATEMENT if that does not decide it
+static StatementType ClassifyStatement(const char *data, idx_t first_token, idx_t end) {
+	auto word_end = WordEnd(data, first_token, end);
+	auto keyword = StatementKeywordTable::Get().Find(data + first_token, word_end - first_token);
+	if (!keyword) {
+		return StatementType::INVALID_STATEMENT;
+	}
+	if (keyword->unless_followed_by) {
+		auto next = SkipSpaceAndComments(data, word_end, end);
+		auto next_end = WordEnd(data, next, end);
+		if (StringUtil::CIEquals(string(data + next, next_end - next), keyword->unless_followed_by)) {
+			return StatementType::INVALID_STATEMENT;
+		}
+	}
+	return keyword->type;
+}
+
+static void ParseStatementTypesFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto limits = GetParseLimits(state.GetContext());
+	ListNameWriter writer(result);
+	vector<StatementPiece> pieces;
+	UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(), [&](string_t query) {
+		writer.Begin();
+		auto data = query.GetData();
+		auto size = query.GetSize();
+		// a single statement is classified straight from the input
+		if (!memchr(data, ';', size)) {
+			auto first_token = SkipSpaceAndComments(data, 0, size);
+			if (first_token == size) {
+				return writer.End();
+			}
+			auto type = ClassifyStatement(data, first_token, size);
+			if (type != StatementType::INVALID_STATEMENT) {
+				writer.AddName(StatementTypeToString(type));
+				return writer.End();
+			}
+		}
+		auto text = query.GetString();
+		pieces.clear();
+		SplitStatements(text, pieces);
+		for (idx_t i = 0; i < pieces.size(); i++) {
+			auto type = ClassifyStatement(text.data(), pieces[i].first_token, pieces[i].end);
+			if (type != StatementType::INVALID_STATEMENT) {
+				writer.AddName(StatementTypeToString(type));
+				continue;
+			}
+			ParseStatementPieces(text, pieces, i, i + 1, limits,
+			                     [&](idx_t piece_idx, SQLStatement *stmt, const string &error, idx_t text_start) {
+				                     if (stmt) {
+					                     writer.AddName(StatementTypeToString(stmt->type));
+				                     } else {
+					                     writer.AddNull();
+				                     }
+			                     });
+		}
+		return writer.End();
+	});
+}
+
+// ============================================================================
+// parse_sql_file(pattern) / parse_sql_file_tables(pattern) - parse SQL files
+// ============================================================================
+//
+// Files are streamed through DuckDB's FileSystem (so compressed and remote files work too) and cut into statements
+// with the same tokenizer split as parse_statements. Only the statements being parsed and the unterminated rest of
+// the last chunk are held in memory, so memory is bounded by the chunk size and the largest statement, not the file.
+// Each file is read by one thread, and multiple files are read in parallel.
+
+static constexpr idx_t SQL_FILE_READ_SIZE = 1024 * 1024;
+
+class SqlFileReader {
+public:
+	SqlFileReader(FileSystem &fs, const string &path)
+	    : handle(fs.OpenFile(path, FileFlags::FILE_FLAGS_READ | FileCompressionType::AUTO_DETECT)) {
+	}
+
+	//! Read the next complete statements, pieces are relative to Buffer(). Returns false at the end of the file.
+	bool Next(vector<StatementPiece> &pieces) {
+		pieces.clear();
+		Consume(consumed);
+		consumed = 0;
+		idx_t read_size = SQL_FILE_READ_SIZE;
+		while (true) {
+			if (!eof) {
+				auto offset = buffer.size();
+				buffer.resize(offset + read_size);
+				auto bytes_read = NumericCast<idx_t>(handle->Read(&buffer[offset], read_size));
+				PoachedStats::Add(PoachedStat::BYTES_IN, bytes_read);
+				buffer.resize(offset + bytes_read);
+				eof = bytes_read == 0;
+			}
+			auto rest = SplitStatements(buffer, pieces, eof);
+			if (!pieces.empty()) {
+				consumed = rest;
+				return true;
+			}
+			if (eof) {
+				return false;
+			}
+			if (rest > 0) {
+				// only empty statements so far
+				Consume(rest);
+			} else {
+				// no statement ends in the buffer yet, read more at once before tokenizing it again
+				read_size *= 2;
+			}
+		}
+	}
+
+	const string &Buffer() const {
+		return buffer;
+	}
+	//! Turn a span located in Buffer() into a span of the file
+	SourceSpan FileSpan(SourceSpan span) const {
+		if (!span.IsValid()) {
+			return span;
+		}
+		if (span.line == 1) {
+			span.column += first_column - 1;
+		}
+		span.line += first_line - 1;
+		span.start_byte += buffer_offset;
+		span.end_byte += buffer_offset;
+		return span;
+	}
+
+private:
+	void Consume(idx_t count) {
+		auto begin = buffer.begin();
+		auto newlines = NumericCast<idx_t>(std::count(begin, begin + count, '\n'));
+		if (newlines == 0) {
+			first_column += count;
+		} else {
+			first_line += newlines;
+			auto last_newline = buffer.rfind('\n', count - 1);
+			first_column = count - last_newline;
+		}
+		buffer.erase(0, count);
+		buffer_offset += count;
+	}
+
+	unique_ptr<FileHandle> handle;
+	bool eof = false;
+	//! Text read but not yet consumed
+	string buffer;
+	idx_t buffer_offset = 0;
+	//! Length of the buffer prefix returned by the last Next
+	idx_t consumed = 0;
+	//! Line and column of the start of the buffer in the file
+	idx_t first_line = 1;
+	idx_t first_column = 1;
+};
+
+struct FileTableRow {
+	idx_t stmt_index;
+	ExtractedTable table;
+};
+
+struct ParseSqlFileBindData : public ParseFunctionData {
+	vector<string> files;
+};
+
+struct ParseSqlFileState : public GlobalTableFunctionState {
+	ParseSqlFileState(idx_t file_count, const vector<column_t> &column_ids)
+	    : file_count(file_count), projection(column_ids) {
+	}
+
+	std::atomic<idx_t> next_file {0};
+	idx_t file_count;
+	ColumnProjection projection;
+
+	idx_t MaxThreads() const override {
+		return MaxValue<idx_t>(file_count, 1);
+	}
+};
+
+template <class ROW>
+struct ParseSqlFileLocalState : public LocalTableFunctionState {
+	//! The file being read, reported as batch index so that files and statements stay in order
+	idx_t file_idx = 0;
+	unique_ptr<SqlFileReader> reader;
+	vector<StatementPiece> pieces;
+	//! Index of the first statement in pieces
+	idx_t stmt_index = 0;
+	vector<ROW> rows;
+	idx_t row_idx = 0;
+};
+
+static unique_ptr<ParseSqlFileBindData> ParseSqlFileBindFiles(ClientContext &context, TableFunctionBindInput &input,
+                                                              vector<LogicalType> &return_types,
+                                                              vector<string> &names) {
+	auto result = make_uniq<ParseSqlFileBindData>();
+	result->limits = GetParseLimits(context);
+	auto &fs = FileSystem::GetFileSystem(context);
+	for (auto &file : fs.GlobFiles(input.inputs[0].GetValue<string>(), context, FileGlobOptions::DISALLOW_EMPTY)) {
+		result->files.push_back(file.path);
+	}
+	std::sort(result->files.begin(), result->files.end());
+
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("filename");
+	return_types.push_back(LogicalType::BIGINT);
+	names.push_back("stmt_index");
+	return result;
+}
+
+static unique_ptr<FunctionData> ParseSqlFileBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = ParseSqlFileBindFiles(context, input, return_types, names);
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("stmt_type");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("error");
+	return_types.push_back(LogicalType::BIGINT);
+	names.push_back("param_count");
+	AddSpanColumns(return_types, names);
+	return std::move(result);
+}
+
+static unique_ptr<FunctionData> ParseSqlFileTablesBind(ClientContext &context, TableFunctionBindInput &input,
+                                                       vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = ParseSqlFileBindFiles(context, input, return_types, names);
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("schema_name");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("table_name");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("context");
+	AddSpanColumns(return_types, names);
+	return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ParseSqlFileInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<ParseSqlFileBindData>();
+	return make_uniq<ParseSqlFileState>(bind_data.files.size(), input.column_ids);
+}
+
+template <class ROW>
+static unique_ptr<LocalTableFunctionState> ParseSqlFileInitLocal(ExecutionContext &context,
+                                                                 TableFunctionInitInput &input,
+                                                                 GlobalTableFunctionState *global_state) {
+	return make_uniq<ParseSqlFileLocalState<ROW>>();
+}
+
+// The file functions return the file and statement index before the columns of parse_statements and parse_tables
+static constexpr idx_t FILE_COLUMN_OFFSET = 2;
+
+static void CollectFileStatements(const ParseFunctionData &bind_data, SqlFileReader &reader,
+                                  const vector<StatementPiece> &pieces, idx_t stmt_index,
+                                  const ColumnProjection &projection, vector<StatementRow> &rows) {
+	auto &buffer = reader.Buffer();
+	unique_ptr<LineIndex> lines;
+	if (ProjectsSpan(projection, FILE_COLUMN_OFFSET + STATEMENT_SPAN_COLUMN)) {
+		lines = make_uniq<LineIndex>(buffer);
+	}
+	auto first_row = rows.size();
+	ParseStatementRows(bind_data, buffer, pieces, 0, pieces.size(), lines.get(),
+	                   projection.Contains(FILE_COLUMN_OFFSET + STATEMENT_ERROR_COLUMN), rows);
+	for (idx_t i = first_row; i < rows.size(); i++) {
+		rows[i].stmt_index += stmt_index;
+		rows[i].span = reader.FileSpan(rows[i].span);
+	}
+}
+
+static void CollectFileTables(const ParseFunctionData &bind_data, SqlFileReader &reader,
+                              const vector<StatementPiece> &pieces, idx_t stmt_index,
+                              const ColumnProjection &projection, vector<FileTableRow> &rows) {
+	SpanLocator spans(reader.Buffer());
+	auto table_spans = ProjectsSpan(projection, FILE_COLUMN_OFFSET + TABLE_SPAN_COLUMN) ? &spans : nullptr;
+	ParseStatementPieces(reader.Buffer(), pieces, 0, pieces.size(), bind_data.limits,
+	                     [&](idx_t piece_idx, SQLStatement *stmt, const string &error, idx_t text_start) {
+		                     if (!stmt) {
+			                     return;
+		                     }
+		                     QueryAnalysis analysis;
+		                     spans.SetBase(text_start);
+		                     QueryAnalyzer analyzer(analysis, AnalysisTarget::TABLES, table_spans);
+		                     analyzer.SetTableContexts(bind_data.filter);
+		                     analyzer.VisitStatement(*stmt);
+		                     for (auto &table : analysis.tables) {
+			                     table.span = reader.FileSpan(table.span);
+			                     rows.push_back(FileTableRow {stmt_index + piece_idx, table});
+		                     }
+	                     });
+}
+
+static void WriteFileStatementRow(DataChunk &output, const ColumnProjection &projection, idx_t out_idx,
+                                  const string &filename, const StatementRow &row) {
+	for (idx_t col_idx = 0; col_idx < projection.columns.size(); col_idx++) {
+		auto &vector = output.data[col_idx];
+		switch (projection.columns[col_idx]) {
+		case 0:
+			vector.SetValue(out_idx, Value(filename));
+			break;
+		case 1:
+			vector.SetValue(out_idx, Value::BIGINT(row.stmt_index));
+			break;
+		case 2:
+			vector.SetValue(out_idx, row.stmt_type.empty() ? Value() : Value(row.stmt_type));
+			break;
+		case 3:
+			vector.SetValue(out_idx, row.error.empty() ? Value() : Value(row.error));
+			break;
+		case 4:
+			vector.SetValue(out_idx, row.stmt_type.empty() ? Value() : Value::BIGINT(row.param_count));
+			break;
+		default:
+			WriteSpanField(vector, projection.columns[col_idx] - FILE_COLUMN_OFFSET - STATEMENT_SPAN_COLUMN, out_idx,
+			               row.span);
+			break;
+		}
+	}
+}
+
+static void WriteFileTableRow(DataChunk &output, const ColumnProjection &projection, idx_t out_idx,
+                              const string &filename, const FileTableRow &row) {
+	for (idx_t col_idx = 0; col_idx < projection.columns.size(); col_idx++) {
+		auto &vector = output.data[col_idx];
+		switch (projection.columns[col_idx]) {
+		case 0:
+			vector.SetValue(out_idx, Value(filename));
+			break;
+		case 1:
+			vector.SetValue(out_idx, Value::BIGINT(row.stmt_index));
+			break;
+		case 2:
+			vector.SetValue(out_idx, row.table.schema.empty() ? Value() : Value(row.table.schema));
+			break;
+		case 3:
+			vector.SetValue(out_idx, Value(row.table.table));
+			break;
+		case 4:
+			vector.SetValue(out_idx, Value(row.table.context));
+			break;
+		default:
+			WriteSpanField(vector, projection.columns[col_idx] - FILE_COLUMN_OFFSET - TABLE_SPAN_COLUMN, out_idx,
+			               row.table.span);
+			break;
+		}
+	}
+}
+
+// COLLECT turns the next statements of a file into result rows, WRITE stores the projected columns of one result row
+// in the output chunk
+template <class ROW,
+          void (*COLLECT)(const ParseFunctionData &bind_data, SqlFileReader &reader,
+                          const vector<StatementPiece> &pieces, idx_t stmt_index, const ColumnProjection &projection,
+                          vector<ROW> &rows),
+          void (*WRITE)(DataChunk &output, const ColumnProjection &projection, idx_t out_idx, const string &filename,
+                        const ROW &row)>
+static void ParseSqlFileFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &bind_data = data_p.bind_data->Cast<ParseSqlFileBindData>();
+	auto &state = data_p.global_state->Cast<ParseSqlFileState>();
+	auto &local_state = data_p.local_state->Cast<ParseSqlFileLocalState<ROW>>();
+
+	// a chunk only holds rows of one file
+	while (local_state.row_idx >= local_state.rows.size()) {
+		local_state.rows.clear();
+		local_state.row_idx = 0;
+		if (!local_state.reader) {
+			auto file_idx = state.next_file++;
+			if (file_idx >= bind_data.files.size()) {
+				output.SetCardinality(0);
+				return;
+			}
+			local_state.file_idx = file_idx;
+			local_state.stmt_index = 0;
+			local_state.reader =
+			    make_uniq<SqlFileReader>(FileSystem::GetFileSystem(context), bind_data.files[file_idx]);
+		}
+		if (!local_state.reader->Next(local_state.pieces)) {
+			local_state.reader.reset();
+			continue;
+		}
+		COLLECT(bind_data, *local_state.reader, local_state.pieces, local_state.stmt_index, state.projection,
+		        local_state.rows);
+		local_state.stmt_index += local_state.pieces.size();
+	}
+
+	auto &filename = bind_data.files[local_state.file_idx];
+	idx_t count = 0;
+	while (local_state.row_idx < local_state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		WRITE(output, state.projection, count++, filename, local_state.rows[local_state.row_idx++]);
+	}
+	output.SetCardinality(count);
+}
+
+template <class ROW>
+static OperatorPartitionData ParseSqlFileGetPartitionData(ClientContext &context,
+                                                          TableFunctionGetPartitionInput &input) {
+	if (input.partition_info.RequiresPartitionColumns()) {
+		throw InternalException("parse_sql_file: partition columns are not supported");
+	}
+	auto &local_state = input.local_state->Cast<ParseSqlFileLocalState<ROW>>();
+	return OperatorPartitionData(local_state.file_idx);
+}
+
+// ============================================================================
+// parse_functions(query) - Extract function calls
+// ============================================================================
+
+struct ParseFunctionsBindData : public ParseQueryBindData {
+	//! Functions of the catalog at bind time, to classify the calls
+	shared_ptr<const FunctionCatalog> catalog;
+};
+
+static constexpr idx_t FUNCTION_TYPE_COLUMN = 1;
+static constexpr idx_t FUNCTION_SPAN_COLUMN = 2;
+
+static void ExtractFunctions(const FunctionData &bind_data, const ColumnProjection &projection, SQLStatement &stmt,
+                             idx_t stmt_index, SpanLocator &spans, vector<FunctionRef> &functions) {
+	QueryAnalysis analysis;
+	auto &data = bind_data.Cast<ParseFunctionsBindData>();
+	auto function_spans = ProjectsSpan(projection, FUNCTION_SPAN_COLUMN) ? &spans : nullptr;
+	QueryAnalyzer analyzer(analysis, AnalysisTarget::FUNCTIONS, function_spans, nullptr, data.catalog.get());
+	analyzer.SetFunctionTypes(data.filter);
+	analyzer.VisitStatement(stmt);
+	functions.insert(functions.end(), analysis.functions.begin(), analysis.functions.end());
+}
+
+static void WriteFunctionRow(DataChunk &output, const ColumnProjection &projection, idx_t out_idx,
+                             const FunctionRef &f) {
+	for (idx_t col_idx = 0; col_idx < projection.columns.size(); col_idx++) {
+		auto &vector = output.data[col_idx];
+		switch (projection.columns[col_idx]) {
+		case 0:
+			vector.SetValue(out_idx, Value(f.name));
+			break;
+		case FUNCTION_TYPE_COLUMN:
+			vector.SetValue(out_idx, Value(f.type));
+			break;
+		default:
+			WriteSpanField(vector, projection.columns[col_idx] - FUNCTION_SPAN_COLUMN, out_idx, f.span);
+			break;
+		}
+	}
+}
+
+static unique_ptr<FunctionData> ParseFunctionsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<ParseFunctionsBindData>();
+	result->limits = GetParseLimits(context);
+	result->catalog = FunctionCatalog::Get(context);
+	if (!input.inputs.empty()) {
+		result->query = input.inputs[0].GetValue<string>();
+	}
+
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("function_name");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("function_type");
+	AddSpanColumns(return_types, names);
+
+	return std::move(result);
+}
+
+// ============================================================================
+// parse_function_names(query) - Returns function names as array
+// ============================================================================
+
+static void ParseFunctionNamesFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto cache = GetParseCache(state);
+	ListNameWriter writer(result);
+	UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(), [&](string_t query) {
+		auto parsed = cache.GetOrParse(query);
+		writer.Begin();
+		AnalyzeNames(parsed->statements, AnalysisTarget::FUNCTIONS, writer);
+		return writer.End();
+	});
+}
+
+// ============================================================================
+// parse_where(query) - Extract WHERE clause conditions
+// ============================================================================
+
+static constexpr idx_t WHERE_COLUMN_NAME_COLUMN = 0;
+static constexpr idx_t WHERE_VALUE_COLUMN = 2;
+static constexpr idx_t WHERE_SPAN_COLUMN = 3;
+
+static void ExtractConditions(const FunctionData &bind_data, const ColumnProjection &projection, SQLStatement &stmt,
+                              idx_t stmt_index, SpanLocator &spans, vector<WhereCondition> &conditions) {
+	QueryAnalysis analysis;
+	auto condition_spans = ProjectsSpan(projection, WHERE_SPAN_COLUMN) ? &spans : nullptr;
+	QueryAnalyzer analyzer(analysis, AnalysisTarget::CONDITIONS, condition_spans);
+	// the operands are printed from the AST, which is the expensive part of a condition
+	analyzer.SetConditionOperands(projection.Contains(WHERE_COLUMN_NAME_COLUMN),
+	                              projection.Contains(WHERE_VALUE_COLUMN));
+	analyzer.VisitStatement(stmt);
+	conditions.insert(conditions.end(), analysis.conditions.begin(), analysis.conditions.end());
+}
+
+static void WriteWhereRow(DataChunk &output, const ColumnProjection &projection, idx_t out_idx,
+                          const WhereCondition &c) {
+	for (idx_t col_idx = 0; col_idx < projection.columns.size(); col_idx++) {
+		auto &vector = output.data[col_idx];
+		switch (projection.columns[col_idx]) {
+		case WHERE_COLUMN_NAME_COLUMN:
+			vector.SetValue(out_idx, Value(c.column_name));
+			break;
+		case 1:
+			vector.SetValue(out_idx, Value(c.op));
+			break;
+		case WHERE_VALUE_COLUMN:
+			vector.SetValue(out_idx, Value(c.value));
+			break;
+		default:
+			WriteSpanField(vector, projection.columns[col_idx] - WHERE_SPAN_COLUMN, out_idx, c.span);
+			break;
+		}
+	}
+}
+
+static unique_ptr<FunctionData> ParseWhereBind(ClientContext &context, TableFunctionBindInput &input,
+                                                vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<ParseQueryBindData>();
+	result->limits = GetParseLimits(context);
+	if (!input.inputs.empty()) {
+		result->query = input.inputs[0].GetValue<string>();
+	}
+
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("column_name");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("operator");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("value");
+	AddSpanColumns(return_types, names);
+
+	return std::move(result);
+}
+
+// ============================================================================
+// parse_analyze(query) - tables, functions, columns and predicates in one pass
+// ============================================================================
+
+static LogicalType VarcharStructList(const vector<string> &field_names) {
+	child_list_t<LogicalType> children;
+	for (auto &name : field_names) {
+		children.push_back(make_pair(name, LogicalType::VARCHAR));
+	}
+	return LogicalType::LIST(LogicalType::STRUCT(std::move(children)));
+}
+
+static LogicalType ParseAnalyzeType() {
+	child_list_t<LogicalType> children;
+	children.push_back(make_pair("tables", VarcharStructList({"schema_name", "table_name", "context"})));
+	children.push_back(make_pair("functions", VarcharStructList({"function_name", "function_type"})));
+	children.push_back(make_pair("columns", VarcharStructList({"table_name", "column_name"})));
+	children.push_back(make_pair("predicates", VarcharStructList({"column_name", "operator", "value"})));
+	children.push_back(make_pair("error", LogicalType::VARCHAR));
+	return LogicalType::STRUCT(std::move(children));
+}
+
+// Append rows to a LIST(STRUCT(VARCHAR, ...)) vector, one struct field per member; empty members become NULL
+template <class ROW>
+static list_entry_t AppendStructRows(Vector &list, const vector<ROW> &rows, const vector<string ROW::*> &members) {
+	auto offset = ListVector::GetListSize(list);
+	ListVector::Reserve(list, offset + rows.size());
+	auto &fields = StructVector::GetEntries(ListVector::GetEntry(list));
+	for (idx_t f = 0; f < members.size(); f++) {
+		auto &field = *fields[f];
+		auto field_data = FlatVector::GetData<string_t>(field);
+		for (idx_t r = 0; r < rows.size(); r++) {
+			auto &value = rows[r].*members[f];
+			if (value.empty()) {
+				FlatVector::SetNull(field, offset + r, true);
+			} else {
+				field_data[offset + r] = StringVector::AddString(field, value);
+			}
+		}
+	}
+	ListVector::SetListSize(list, offset + rows.size());
+	return list_entry_t {offset, rows.size()};
+}
+
+struct ParseAnalyzeBindData : public FunctionData {
+	explicit ParseAnalyzeBindData(shared_ptr<const FunctionCatalog> catalog_p) : catalog(std::move(catalog_p)) {
+	}
+
+	//! Functions of the catalog at bind time, to classify the calls
+	shared_ptr<const FunctionCatalog> catalog;
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<ParseAnalyzeBindData>(catalog);
+	}
+	bool Equals(const FunctionData &other_p) const override {
+		return catalog == other_p.Cast<ParseAnalyzeBindData>().catalog;
+	}
+};
+
+static unique_ptr<FunctionData> ParseAnalyzeBind(ClientContext &context, ScalarFunction &bound_function,
+                                                 vector<unique_ptr<Expression>> &arguments) {
+	return make_uniq<ParseAnalyzeBindData>(FunctionCatalog::Get(context));
+}
+
+static void ParseAnalyzeFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto cache = GetParseCache(state);
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &catalog = *func_expr.bind_info->Cast<ParseAnalyzeBindData>().catalog;
+	auto count = args.size();
+
+	UnifiedVectorFormat vdata;
+	args.data[0].ToUnifiedFormat(count, vdata);
+	auto input_data = UnifiedVectorFormat::GetData<string_t>(vdata);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto &entries = StructVector::GetEntries(result);
+	auto &tables = *entries[0];
+	auto &functions = *entries[1];
+	auto &columns = *entries[2];
+	auto &predicates = *entries[3];
+	auto &error = *entries[4];
+
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		if (!vdata.validity.RowIsValid(idx)) {
+			FlatVector::SetNull(result, i, true);
+			continue;
+		}
+		auto parsed = cache.GetOrParse(input_data[idx]);
+		QueryAnalysis analysis;
+		AnalyzeStatements(parsed->statements, analysis, AnalysisTarget::ALL, nullptr, &catalog);
+
+		FlatVector::GetData<list_entry_t>(tables)[i] = AppendStructRows<ExtractedTable>(
+		    tables, analysis.tables, {&ExtractedTable::schema, &ExtractedTable::table, &ExtractedTable::context});
+		FlatVector::GetData<list_entry_t>(functions)[i] =
+		    AppendStructRows<FunctionRef>(functions, analysis.functions, {&FunctionRef::name, &FunctionRef::type});
+		FlatVector::GetData<list_entry_t>(columns)[i] = AppendStructRows<ColumnReference>(
+		    columns, analysis.columns, {&ColumnReference::table, &ColumnReference::column});
+		FlatVector::GetData<list_entry_t>(predicates)[i] = AppendStructRows<WhereCondition>(
+		    predicates, analysis.conditions,
+		    {&WhereCondition::column_name, &WhereCondition::op, &WhereCondition::value});
+		if (parsed->success) {
+			FlatVector::SetNull(error, i, true);
+		} else {
+			FlatVector::GetData<string_t>(error)[i] = StringVector::AddString(error, parsed->error);
+		}
+	}
+}
+
+// ============================================================================
+// parse_ast(query) - the statement tree as a list of nodes
+// ============================================================================
+
+static LogicalType AstNodeType() {
+	child_list_t<LogicalType> children;
+	children.push_back(make_pair("node_id", LogicalType::BIGINT));
+	children.push_back(make_pair("parent_id", LogicalType::BIGINT));
+	children.push_back(make_pair("node_type", LogicalType::VARCHAR));
+	children.push_back(make_pair("kind", LogicalType::VARCHAR));
+	children.push_back(make_pair("role", LogicalType::VARCHAR));
+	children.push_back(make_pair("name", LogicalType::VARCHAR));
+	children.push_back(make_pair("alias", LogicalType::VARCHAR));
+	children.push_back(make_pair("children", LogicalType::LIST(LogicalType::BIGINT)));
+	children.push_back(make_pair("start_byte", LogicalType::BIGINT));
+	children.push_back(make_pair("end_byte", LogicalType::BIGINT));
+	return LogicalType::STRUCT(std::move(children));
+}
+
+static void WriteOptionalString(Vector &vector, idx_t idx, const string &value) {
+	if (value.empty()) {
+		FlatVector::SetNull(vector, idx, true);
+	} else {
+		FlatVector::GetData<string_t>(vector)[idx] = StringVector::AddString(vector, value);
+	}
+}
+
+// Append nodes to a LIST(AstNodeType()) vector
+static list_entry_t AppendAstNodes(Vector &list, const vector<AstNode> &nodes) {
+	auto offset = ListVector::GetListSize(list);
+	ListVector::Reserve(list, offset + nodes.size());
+	auto &fields = StructVector::GetEntries(ListVector::GetEntry(list));
+	auto node_ids = FlatVector::GetData<int64_t>(*fields[0]);
+	auto parent_ids = FlatVector::GetData<int64_t>(*fields[1]);
+	auto &children = *fields[7];
+	auto start_bytes = FlatVector::GetData<int64_t>(*fields[8]);
+	auto end_bytes = FlatVector::GetData<int64_t>(*fields[9]);
+
+	idx_t child_count = 0;
+	for (auto &node : nodes) {
+		child_count += node.children.size();
+	}
+	auto child_offset = ListVector::GetListSize(children);
+	ListVector::Reserve(children, child_offset + child_count);
+	auto child_ids = FlatVector::GetData<int64_t>(ListVector::GetEntry(children));
+	auto child_entries = FlatVector::GetData<list_entry_t>(children);
+
+	for (idx_t r = 0; r < nodes.size(); r++) {
+		auto &node = nodes[r];
+		auto out = offset + r;
+		node_ids[out] = NumericCast<int64_t>(node.id);
+		if (node.parent == AST_NO_PARENT) {
+			FlatVector::SetNull(*fields[1], out, true);
+		} else {
+			parent_ids[out] = NumericCast<int64_t>(node.parent);
+		}
+		WriteOptionalString(*fields[2], out, node.node_type);
+		WriteOptionalString(*fields[3], out, node.kind);
+		WriteOptionalString(*fields[4], out, node.role);
+		WriteOptionalString(*fields[5], out, node.name);
+		WriteOptionalString(*fields[6], out, node.alias);
+		child_entries[out] = list_entry_t {child_offset, node.children.size()};
+		for (auto child : node.children) {
+			child_ids[child_offset++] = NumericCast<int64_t>(child);
+		}
+		if (node.span.IsValid()) {
+			start_bytes[out] = NumericCast<int64_t>(node.span.start_byte);
+			end_bytes[out] = NumericCast<int64_t>(node.span.end_byte);
+		} else {
+			FlatVector::SetNull(*fields[8], out, true);
+			FlatVector::SetNull(*fields[9], out, true);
+		}
+	}
+	ListVector::SetListSize(children, child_offset);
+	ListVector::SetListSize(list, offset + nodes.size());
+	return list_entry_t {offset, nodes.size()};
+}
+
+// NULL if the query does not parse
+static void ParseAstFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto cache = GetParseCache(state);
+	vector<AstNode> nodes;
+	UnaryExecutor::ExecuteWithNulls<string_t, list_entry_t>(
+	    args.data[0], result, args.size(), [&](string_t query, ValidityMask &mask, idx_t idx) {
+		    auto parsed = cache.GetOrParse(query);
+		    if (!parsed->success) {
+			    mask.SetInvalid(idx);
+			    return list_entry_t();
+		    }
+		    auto query_string = query.GetString();
+		    SpanLocator spans(query_string);
+		    nodes.clear();
+		    BuildAst(parsed->statements, nodes, &spans);
+		    return AppendAstNodes(result, nodes);
+	    });
+}
+
+// ============================================================================
+// sql_strip_comments(query) - Remove comments from SQL
+// ============================================================================
+
+// The scanner skips ahead a word at a time to the next byte that can start a comment or a string literal and copies
+// whole runs between comments. Text without comments is returned as is, without copying it.
+
+static constexpr uint64_t SWAR_ONES = 0x0101010101010101ULL;
+static constexpr uint64_t SWAR_HIGH_BITS = 0x8080808080808080ULL;
+
+// Whether any byte of word equals the byte repeated in pattern
+static inline bool WordHasByte(uint64_t word, uint64_t pattern) {
+	auto x = word ^ pattern;
+	return ((x - SWAR_ONES) & ~x & SWAR_HIGH_BITS) != 0;
+}
+
+static inline bool IsCommentCandidate(char c) {
+	return c == '-' || c == '/' || c == '\'' || c == '"';
+}
+
+// Returns the position of the first byte at or after pos that may start a comment or string literal, or size
+static idx_t FindCommentCandidate(const char *data, idx_t pos, idx_t size) {
+	while (pos + sizeof(uint64_t) <= size) {
+		uint64_t word;
+		memcpy(&word, data + pos, sizeof(uint64_t));
+		if (WordHasByte(word, SWAR_ONES * '-') || WordHasByte(word, SWAR_ONES * '/') ||
+		    WordHasByte(word, SWAR_ONES * '\'') || WordHasByte(word, SWAR_ONES * '"')) {
+			break;
+		}
+		pos += sizeof(uint64_t);
+	}
+	for (; pos < size; pos++) {
+		if (IsCommentCandidate(data[pos])) {
+			return pos;
+		}
+	}
+	return size;
+}
+
+// Writes data without its comments to output, returns false (leaving output untouched) if there are none.
+// Line comments keep their terminating newline, unterminated comments run to the end of the text.
+static bool StripSqlComments(const char *data, idx_t size, string &output) {
+	bool stripped = false;
+	idx_t run_start = 0;
+	idx_t pos = 0;
+	while ((pos = FindCommentCandidate(data, pos, size)) + 1 < size) {
+		auto c = data[pos];
+		if (c == '\'' || c == '"') {
+			pos = SkipStringLiteral(data, pos, size);
+			continue;
+		}
+		auto next = data[pos + 1];
+		if ((c != '-' || next != '-') && (c != '/' || next != '*')) {
+			pos++;
+			continue;
+		}
+		if (!stripped) {
+			output.reserve(size);
+			stripped = true;
+		}
+		output.append(data + run_start, pos - run_start);
+		pos += 2;
+		if (c == '-') {
+			auto newline = static_cast<const char *>(memchr(data + pos, '\n', size - pos));
+			pos = newline ? NumericCast<idx_t>(newline - data) : size;
+		} else {
+			pos = FindBlockCommentEnd(data, pos, size);
+		}
+		run_start = pos;
+	}
+	if (stripped) {
+		output.append(data + run_start, size - run_start);
+	}
+	return stripped;
+}
+
+static void SqlStripCommentsFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &input = args.data[0];
+	// rows without comments are returned as is and point into the input strings
+	StringVector::AddHeapReference(result, input);
+	UnaryExecutor::Execute<string_t, string_t>(input, result, args.size(), [&](string_t query) {
+		string output;
+		if (!StripSqlComments(query.GetData(), query.GetSize(), output)) {
+			return query;
+		}
+		return StringVector::AddString(result, output);
+	});
+}
+
+// ============================================================================
+// parse_normalize(query) / parse_fingerprint(query) - query shape for grouping
+// ============================================================================
+//
+// Both walk the token stream of the query once, without its comment tokens: constants (with a unary sign) and
+// parameters become ?, lists of constants in IN (...) collapse to a single ?, keywords are upper-cased and whitespace
+// is normalized. parse_normalize writes the tokens into a string, parse_fingerprint only hashes them, so equal
+// normalized texts have equal fingerprints.
+
+static bool TokenIs(const string &query, const TokenRow &token, const char *text) {
+	auto size = strlen(text);
+	return static_cast<idx_t>(token.length) == size && memcmp(query.data() + token.start, text, size) == 0;
+}
+
+static bool IsConstantToken(const string &query, const TokenRow &token) {
+	if (token.category == TOKEN_NUMERIC_CONSTANT || token.category == TOKEN_STRING_CONSTANT) {
+		return true;
+	}
+	// prepared statement parameters: ? and $n
+	auto text = query.data() + token.start;
+	return TokenIs(query, token, "?") || (token.length > 1 && text[0] == '$' && StringUtil::CharacterIsDigit(text[1]));
+}
+
+static bool IsInKeyword(const string &query, const TokenRow &token) {
+	auto text = query.data() + token.start;
+	return token.length == 2 && StringUtil::CharacterToLower(text[0]) == 'i' &&
+	       StringUtil::CharacterToLower(text[1]) == 'n';
+}
+
+// Whether the token at i is the sign of the constant after it: a "-" or "+" that is unary as it follows a keyword or
+// an operator other than a closing bracket (or starts the query)
+static bool IsConstantSign(const string &query, const vector<TokenRow> &tokens, idx_t i) {
+	if ((!TokenIs(query, tokens[i], "-") && !TokenIs(query, tokens[i], "+")) || i + 1 >= tokens.size() ||
+	    !IsConstantToken(query, tokens[i + 1])) {
+		return false;
+	}
+	if (i == 0) {
+		return true;
+	}
+	auto &previous = tokens[i - 1];
+	if (previous.category == TOKEN_KEYWORD) {
+		return true;
+	}
+	return previous.category == TOKEN_OPERATOR && !IsConstantToken(query, previous) && !TokenIs(query, previous, ")") &&
+	       !TokenIs(query, previous, "]");
+}
+
+// Returns the index of the ")" closing a non-empty list of (signed) constants opened at open_idx, or 0
+static idx_t FindConstantListEnd(const string &query, const vector<TokenRow> &tokens, idx_t open_idx) {
+	idx_t i = open_idx + 1;
+	while (i < tokens.size()) {
+		if (TokenIs(query, tokens[i], "-") || TokenIs(query, tokens[i], "+")) {
+			i++;
+		}
+		if (i >= tokens.size() || !IsConstantToken(query, tokens[i])) {
+			return 0;
+		}
+		i++;
+		if (i < tokens.size() && TokenIs(query, tokens[i], ")")) {
+			return i;
+		}
+		if (i >= tokens.size() || !TokenIs(query, tokens[i], ",")) {
+			return 0;
+		}
+		i++;
+	}
+	return 0;
+}
+
+// The query text and token buffers of NormalizeQuery, reused for all rows of a chunk
+struct NormalizeBuffers {
+	string query;
+	vector<TokenRow> tokens;
+};
+
+template <class WRITER>
+static void NormalizeQuery(const string_t &input, WRITER &writer, NormalizeBuffers &buffers) {
+	// Parser::Tokenize takes a std::string, so the query is copied into the buffer rather than into a new string
+	auto &query = buffers.query;
+	auto &tokens = buffers.tokens;
+	query.assign(input.GetData(), input.GetSize());
+	TokenizeQuery(query, tokens);
+	// drop the comment tokens so a comment cannot split an IN list or separate a keyword from its neighbours
+	tokens.erase(std::remove_if(tokens.begin(), tokens.end(),
+	                            [](const TokenRow &token) { return token.category == TOKEN_COMMENT; }),
+	             tokens.end());
+	for (idx_t i = 0; i < tokens.size(); i++) {
+		auto &token = tokens[i];
+		if (IsConstantSign(query, tokens, i)) {
+			// the sign is part of the constant, so x = -5 has the shape of x = 5
+			continue;
+		}
+		if (IsConstantToken(query, token)) {
+			writer.Write("?", 1, TOKEN_NUMERIC_CONSTANT);
+			continue;
+		}
+		writer.Write(query.data() + token.start, NumericCast<idx_t>(token.length), token.category);
+		if (token.category == TOKEN_KEYWORD && IsInKeyword(query, token) && i + 1 < tokens.size() &&
+		    TokenIs(query, tokens[i + 1], "(")) {
+			auto list_end = FindConstantListEnd(query, tokens, i + 1);
+			if (list_end) {
+				writer.Write("(", 1, TOKEN_OPERATOR);
+				writer.Write("?", 1, TOKEN_NUMERIC_CONSTANT);
+				writer.Write(")", 1, TOKEN_OPERATOR);
+				i = list_end;
+			}
+		}
+	}
+}
+
+static bool IsSingleChar(const char *data, idx_t size, const char *chars) {
+	return size == 1 && strchr(chars, data[0]) != nullptr;
+}
+
+// Writes the tokens separated by single spaces, except around punctuation and between a function name and its "("
+struct NormalizedQueryWriter {
+	string output;
+	bool space_after = false;
+	uint8_t previous_category = TOKEN_ERROR;
+
+	//! Start a new query, keeping the output buffer
+	void Reset() {
+		output.clear();
+		space_after = false;
+		previous_category = TOKEN_ERROR;
+	}
+
+	void Write(const char *data, idx_t size, uint8_t category) {
+		bool attach = IsSingleChar(data, size, ",)]") || (size == 1 && data[0] == '.') ||
+		              (size == 2 && memcmp(data, "::", 2) == 0) ||
+		              (size == 1 && data[0] == '(' && previous_category == TOKEN_IDENTIFIER);
+		if (space_after && !attach) {
+			output += ' ';
+		}
+		if (category == TOKEN_KEYWORD) {
+			for (idx_t i = 0; i < size; i++) {
+				output += StringUtil::CharacterToUpper(data[i]);
+			}
+		} else {
+			output.append(data, size);
+		}
+		space_after = !IsSingleChar(data, size, "([.") && !(size == 2 && memcmp(data, "::", 2) == 0);
+		previous_category = category;
+	}
+};
+
+// Hashes the tokens as NormalizedQueryWriter would write them, without building the string
+struct FingerprintWriter {
+	hash_t hash = 0;
+
+	void Write(const char *data, idx_t size, uint8_t category) {
+		char upper[64];
+		if (category == TOKEN_KEYWORD && size <= sizeof(upper)) {
+			for (idx_t i = 0; i < size; i++) {
+				upper[i] = StringUtil::CharacterToUpper(data[i]);
+			}
+			data = upper;
+		}
+		hash = CombineHash(hash, Hash(data, size));
+	}
+};
+
+static void ParseNormalizeFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	NormalizeBuffers buffers;
+	NormalizedQueryWriter writer;
+	UnaryExecutor::Execute<string_t, string_t>(args.data[0], result, args.size(), [&](string_t query) {
+		writer.Reset();
+		NormalizeQuery(query, writer, buffers);
+		return StringVector::AddString(result, writer.output);
+	});
+}
+
+static void ParseFingerprintFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	NormalizeBuffers buffers;
+	UnaryExecutor::Execute<string_t, uint64_t>(args.data[0], result, args.size(), [&](string_t query) {
+		FingerprintWriter writer;
+		NormalizeQuery(query, writer, buffers);
+		return static_cast<uint64_t>(writer.hash);
+	});
+}
+
+// ============================================================================
+// parse_signature(query) - fixed-width query signature for comparing query logs
+// ============================================================================
+//
+// The fingerprint, the statement type and hashes of the sets of referenced tables and called functions, all
+// fixed-width, so that comparing two query logs is a join on integer columns. The fingerprint is hashed from the
+// tokens as in parse_fingerprint, the rest comes from a single walk of the (cached) parse.
+
+//! The statement types after INVALID_STATEMENT, whose enum index is their StatementType minus one. Types added to
+//! DuckDB after MERGE_INTO_STATEMENT are not in the enum, their stmt_type is NULL.
+static constexpr idx_t SIGNATURE_TYPE_COUNT = static_cast<idx_t>(StatementType::MERGE_INTO_STATEMENT);
+static_assert(static_cast<idx_t>(StatementType::MULTI_STATEMENT) <= SIGNATURE_TYPE_COUNT,
+              "the signature statement types must include MULTI_STATEMENT");
+
+static LogicalType SignatureStatementType() {
+	Vector types(LogicalType::VARCHAR, SIGNATURE_TYPE_COUNT);
+	auto data = FlatVector::GetData<string_t>(types);
+	for (idx_t i = 0; i < SIGNATURE_TYPE_COUNT; i++) {
+		data[i] = StringVector::AddString(types, StatementTypeToString(static_cast<StatementType>(i + 1)));
+	}
+	return LogicalType::ENUM(types, SIGNATURE_TYPE_COUNT);
+}
+
+static LogicalType ParseSignatureType() {
+	child_list_t<LogicalType> children;
+	children.push_back(make_pair("fingerprint", LogicalType::UBIGINT));
+	children.push_back(make_pair("stmt_type", SignatureStatementType()));
+	children.push_back(make_pair("table_set_hash", LogicalType::UBIGINT));
+	children.push_back(make_pair("function_set_hash", LogicalType::UBIGINT));
+	return LogicalType::STRUCT(std::move(children));
+}
+
+// Collects the case-insensitive hashes of the (schema-qualified) table and function names of a walk
+class NameSetHasher : public NameSink {
+public:
+	void AddName(const string &name) override {
+		tables.push_back(StringUtil::CIHash(name));
+	}
+	void AddTableName(const string &schema, const string &name) override {
+		auto hash = StringUtil::CIHash(name);
+		tables.push_back(schema.empty() ? hash : CombineHash(StringUtil::CIHash(schema), hash));
+	}
+	void AddFunctionName(const string &name) override {
+		functions.push_back(StringUtil::CIHash(name));
+	}
+
+	//! The hash of the distinct names, independent of their order and repetitions; 0 for no names
+	static uint64_t SetHash(vector<hash_t> &hashes) {
+		std::sort(hashes.begin(), hashes.end());
+		hash_t hash = 0;
+		for (idx_t i = 0; i < hashes.size(); i++) {
+			if (i == 0 || hashes[i] != hashes[i - 1]) {
+				hash = CombineHash(hash, hashes[i]);
+			}
+		}
+		return static_cast<uint64_t>(hash);
+	}
+
+	vector<hash_t> tables;
+	vector<hash_t> functions;
+};
+
+static void ParseSignatureFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto cache = GetParseCache(state);
+	auto count = args.size();
+
+	UnifiedVectorFormat vdata;
+	args.data[0].ToUnifiedFormat(count, vdata);
+	auto input_data = UnifiedVectorFormat::GetData<string_t>(vdata);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto &entries = StructVector::GetEntries(result);
+	auto fingerprints = FlatVector::GetData<uint64_t>(*entries[0]);
+	auto types = FlatVector::GetData<uint8_t>(*entries[1]);
+	auto table_hashes = FlatVector::GetData<uint64_t>(*entries[2]);
+	auto function_hashes = FlatVector::GetData<uint64_t>(*entries[3]);
+	constexpr auto targets = static_cast<AnalysisTarget>(static_cast<uint8_t>(AnalysisTarget::TABLES) |
+	                                                     static_cast<uint8_t>(AnalysisTarget::FUNCTIONS));
+
+	NormalizeBuffers buffers;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		if (!vdata.validity.RowIsValid(idx)) {
+			FlatVector::SetNull(result, i, true);
+			continue;
+		}
+		auto &query = input_data[idx];
+		FingerprintWriter fingerprint;
+		NormalizeQuery(query, fingerprint, buffers);
+		fingerprints[i] = static_cast<uint64_t>(fingerprint.hash);
+
+		// a query that does not parse only has its fingerprint
+		auto parsed = cache.GetOrParse(query);
+		if (!parsed->success || parsed->statements.empty()) {
+			for (idx_t e = 1; e < entries.size(); e++) {
+				FlatVector::SetNull(*entries[e], i, true);
+			}
+			continue;
+		}
+		auto type = parsed->statements.size() == 1 ? parsed->statements[0]->type : StatementType::MULTI_STATEMENT;
+		auto type_index = static_cast<idx_t>(type);
+		if (type_index == 0 || type_index > SIGNATURE_TYPE_COUNT) {
+			FlatVector::SetNull(*entries[1], i, true);
+		} else {
+			types[i] = static_cast<uint8_t>(type_index - 1);
+		}
+		NameSetHasher names;
+		AnalyzeNames(parsed->statements, targets, names);
+		table_hashes[i] = NameSetHasher::SetHash(names.tables);
+		function_hashes[i] = NameSetHasher::SetHash(names.functions);
+	}
+}
+
+// ============================================================================
+// parse_columns(query, stmt_index) - Get SELECT column names
+// ============================================================================
+
+struct ColumnRow {
+	idx_t col_index;
+	string col_name;
+	SourceSpan span;
+};
+
+struct ParseColumnsBindData : public ParseQueryBindData {
+	idx_t stmt_index = 0;
+};
+
+// The SELECT list of a statement, nullptr if it is not a SELECT
+static const vector<unique_ptr<ParsedExpression>> *GetSelectList(const SQLStatement &stmt) {
+	if (stmt.type == StatementType::SELECT_STATEMENT) {
+		auto &select = stmt.Cast<SelectStatement>();
+		if (select.node && select.node->type == QueryNodeType::SELECT_NODE) {
+			return &select.node->Cast<SelectNode>().select_list;
+		}
+	}
+	return nullptr;
+}
+
+static constexpr idx_t COLUMN_NAME_COLUMN = 1;
+static constexpr idx_t COLUMN_SPAN_COLUMN = 2;
+
+// The SELECT list of a statement, with the span of each expression and its alias
+static void ExtractColumns(const FunctionData &bind_data, const ColumnProjection &projection, SQLStatement &stmt,
+                           idx_t stmt_index, SpanLocator &spans, vector<ColumnRow> &columns) {
+	auto select_list = GetSelectList(stmt);
+	if (!select_list) {
+		return;
+	}
+	auto with_names = projection.Contains(COLUMN_NAME_COLUMN);
+	auto with_spans = ProjectsSpan(projection, COLUMN_SPAN_COLUMN);
+	string scratch;
+	for (idx_t i = 0; i < select_list->size(); i++) {
+		auto &expr = *(*select_list)[i];
+		ColumnRow row {i, string(), SourceSpan()};
+		if (with_names) {
+			row.col_name = GetExpressionName(expr, scratch);
+		}
+		if (with_spans) {
+			row.span = spans.ExpressionSpan(expr);
+			spans.ExtendOverAlias(row.span, expr.alias);
+		}
+		columns.push_back(std::move(row));
+	}
+}
+
+static void WriteColumnRow(DataChunk &output, const ColumnProjection &projection, idx_t out_idx,
+                           const ColumnRow &row) {
+	for (idx_t col_idx = 0; col_idx < projection.columns.size(); col_idx++) {
+		auto &vector = output.data[col_idx];
+		switch (projection.columns[col_idx]) {
+		case 0:
+			vector.SetValue(out_idx, Value::BIGINT(row.col_index));
+			break;
+		case COLUMN_NAME_COLUMN:
+			vector.SetValue(out_idx, Value(row.col_name));
+			break;
+		default:
+			WriteSpanField(vector, projection.columns[col_idx] - COLUMN_SPAN_COLUMN, out_idx, row.span);
+			break;
+		}
+	}
+}
+
+static unique_ptr<FunctionData> ParseColumnsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<ParseColumnsBindData>();
+	result->limits = GetParseLimits(context);
+	if (!input.inputs.empty()) {
+		result->query = input.inputs[0].GetValue<string>();
+		auto stmt_index = input.inputs[1].GetValue<int64_t>();
+		result->stmt_index = stmt_index < 0 ? DConstants::INVALID_INDEX : NumericCast<idx_t>(stmt_index);
+	}
+
+	return_types.push_back(LogicalType::BIGINT);
+	names.push_back("col_index");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("col_name");
+	AddSpanColumns(return_types, names);
+
+	return std::move(result);
+}
+
+// Only the requested statement is parsed
+static unique_ptr<GlobalTableFunctionState> ParseColumnsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<ParseColumnsBindData>();
+	auto result = make_uniq<ParseQueryScanState<ColumnRow>>(bind_data.query, input.column_ids);
+	if (bind_data.stmt_index < result->end_piece) {
+		result->next_piece = bind_data.stmt_index;
+		result->end_piece = bind_data.stmt_index + 1;
+	} else {
+		result->next_piece = result->end_piece;
+	}
+	return std::move(result);
+}
+
+static void ParseColumnsInOutCollect(const FunctionData &bind_data, const ColumnProjection &projection,
+                                     DataChunk &input, const UnifiedVectorFormat &query_data, idx_t row_idx,
+                                     vector<ColumnRow> &rows) {
+	string query;
+	if (!GetInOutString(query_data, row_idx, query)) {
+		return;
+	}
+	auto stmt_index = input.data[1].GetValue(row_idx);
+	if (stmt_index.IsNull() || stmt_index.GetValue<int64_t>() < 0) {
+		return;
+	}
+	vector<StatementPiece> pieces;
+	SplitStatements(query, pieces);
+	auto piece_idx = NumericCast<idx_t>(stmt_index.GetValue<int64_t>());
+	if (piece_idx < pieces.size()) {
+		SpanLocator spans(query);
+		ExtractStatementRows<ColumnRow, ExtractColumns>(bind_data, projection, query, pieces, piece_idx,
+		                                                piece_idx + 1, spans, rows);
+	}
+}
+
+// ============================================================================
+// parse_column_names(query, stmt_index) - Get SELECT column names as array
+// ============================================================================
+
+static void ParseColumnNamesFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto cache = GetParseCache(state);
+	ListNameWriter writer(result);
+	string scratch;
+	BinaryExecutor::Execute<string_t, int64_t, list_entry_t>(
+	    args.data[0], args.data[1], result, args.size(), [&](string_t query, int64_t stmt_index) {
+		    writer.Begin();
+		    if (stmt_index >= 0) {
+			    auto parsed = cache.GetOrParse(query);
+			    auto &statements = parsed->statements;
+			    auto select_list = static_cast<idx_t>(stmt_index) < statements.size()
+			                           ? GetSelectList(*statements[static_cast<idx_t>(stmt_index)])
+			                           : nullptr;
+			    if (select_list) {
+				    for (auto &expr : *select_list) {
+					    writer.AddName(GetExpressionName(*expr, scratch));
+				    }
+			    }
+		    }
+		    return writer.End();
+	    });
+}
+
+// ============================================================================
+// parse_lineage(query) - Resolve output columns to the source columns they depend on
 // ============================================================================
 
-static void ParseTableNamesFunc(DataChunk &args, ExpressionState &state, Vector &result) {
-	UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(), [&](string_t query) {
-		vector<ExtractedTable> tables;
-		try {
-			Parser parser;
-			parser.ParseQuery(query.GetString());
-			for (auto &stmt : parser.statements) {
-				ExtractTablesFromStatement(stmt.get(), tables);
-			}
-		} catch (...) {
-		}
+//! One source of an output column; a column computed from constants alone has a single row with an empty source
+struct LineageRow {
+	idx_t col_index;
+	string col_name;
+	LineageSource source;
+};
 
-		auto &child = ListVector::GetEntry(result);
-		auto current_size = ListVector::GetListSize(result);
+static void ExtractLineage(const FunctionData &bind_data, const ColumnProjection &projection, SQLStatement &stmt,
+                           idx_t stmt_index, SpanLocator &spans, vector<LineageRow> &rows) {
+	vector<ColumnLineage> columns;
+	ResolveLineage(stmt, columns);
+	for (idx_t i = 0; i < columns.size(); i++) {
+		auto &column = columns[i];
+		if (column.sources.empty()) {
+			rows.push_back(LineageRow {i, column.name, LineageSource()});
+		}
+		for (auto &source : column.sources) {
+			rows.push_back(LineageRow {i, column.name, source});
+		}
+	}
+}
 
-		for (auto &t : tables) {
-			child.SetValue(current_size++, Value(t.table));
+static void WriteLineageRow(DataChunk &output, const ColumnProjection &projection, idx_t out_idx,
+                            const LineageRow &row) {
+	for (idx_t col_idx = 0; col_idx < projection.columns.size(); col_idx++) {
+		auto &vector = output.data[col_idx];
+		switch (projection.columns[col_idx]) {
+		case 0:
+			vector.SetValue(out_idx, Value::BIGINT(row.col_index));
+			break;
+		case 1:
+			vector.SetValue(out_idx, Value(row.col_name));
+			break;
+		case 2:
+			vector.SetValue(out_idx, row.source.schema.empty() ? Value() : Value(row.source.schema));
+			break;
+		case 3:
+			vector.SetValue(out_idx, row.source.table.empty() ? Value() : Value(row.source.table));
+			break;
+		case 4:
+			vector.SetValue(out_idx, row.source.column.empty() ? Value() : Value(row.source.column));
+			break;
+		default:
+			vector.SetValue(out_idx, Value());
+			break;
 		}
-		ListVector::SetListSize(result, current_size);
+	}
+}
 
-		return list_entry_t{current_size - tables.size(), tables.size()};
-	});
+static unique_ptr<FunctionData> ParseLineageBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<ParseQueryBindData>();
+	result->limits = GetParseLimits(context);
+	if (!input.inputs.empty()) {
+		result->query = input.inputs[0].GetValue<string>();
+	}
+
+	return_types.push_back(LogicalType::BIGINT);
+	names.push_back("col_index");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("col_name");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("source_schema");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("source_table");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("source_column");
+
+	return std::move(result);
 }
 
 // ============================================================================
-// Helper: Extract function calls from expressions
+// parse_parameters(query) - Extract prepared statement parameters
 // ============================================================================
 
-struct FunctionRef {
+//! An occurrence of a parameter; a parameter used twice has two rows with the same index
+struct ParameterRow {
+	idx_t stmt_index;
+	//! The position of the value bound to the parameter, 1-based
+	idx_t param_index;
 	string name;
-	string type; // "scalar" or "aggregate"
+	const char *style;
+	string column;
+	SourceSpan span;
 };
 
-static bool IsAggregateFunction(const string &name) {
-	// Common aggregate functions
-	static const unordered_set<string> aggregates = {
-		"count", "count_star", "sum", "avg", "min", "max",
-		"first", "last", "any_value", "arbitrary",
-		"stddev", "stddev_pop", "stddev_samp",
-		"variance", "var_pop", "var_samp",
-		"covar_pop", "covar_samp", "corr",
-		"string_agg", "group_concat", "listagg",
-		"array_agg", "list", "histogram",
-		"approx_count_distinct", "approx_quantile",
-		"median", "quantile", "quantile_cont", "quantile_disc",
-		"mode", "entropy", "kurtosis", "skewness",
-		"regr_avgx", "regr_avgy", "regr_count", "regr_intercept",
-		"regr_r2", "regr_slope", "regr_sxx", "regr_sxy", "regr_syy",
-		"bit_and", "bit_or", "bit_xor", "bool_and", "bool_or"
-	};
-	string lower_name = name;
-	std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
-	return aggregates.find(lower_name) != aggregates.end();
-}
+static constexpr idx_t PARAMETER_SPAN_COLUMN = 5;
 
-static void ExtractFunctionsFromExpression(ParsedExpression *expr, vector<FunctionRef> &functions) {
-	if (!expr) return;
+static bool IsParameterNameChar(char c) {
+	return StringUtil::CharacterIsAlphaNumeric(c) || c == '_' || static_cast<unsigned char>(c) >= 0x80;
+}
 
-	if (expr->type == ExpressionType::FUNCTION) {
-		auto &fn = expr->Cast<FunctionExpression>();
-		FunctionRef f;
-		f.name = fn.function_name;
-		f.type = fn.is_operator ? "operator" : (IsAggregateFunction(fn.function_name) ? "aggregate" : "scalar");
-		functions.push_back(f);
-		// Recurse into function arguments
-		for (auto &child : fn.children) {
-			ExtractFunctionsFromExpression(child.get(), functions);
+// How a parameter is written: "?" without a number is anonymous, "$1" (or "?1") positional and "$name" named
+static const char *ParameterStyle(const SpanLocator &spans, const ParameterRef &param) {
+	if (param.name.empty() || !StringUtil::CharacterIsDigit(param.name[0])) {
+		return "named";
+	}
+	if (param.location.IsValid()) {
+		auto location = param.location.GetIndex();
+		if (spans.At(location) == '?' && !StringUtil::CharacterIsDigit(spans.At(location + 1))) {
+			return "anonymous";
 		}
 	}
+	return "positional";
 }
 
-static void ExtractFunctionsFromQueryNode(QueryNode *node, vector<FunctionRef> &functions) {
-	if (!node) return;
-
-	if (node->type == QueryNodeType::SELECT_NODE) {
-		auto &select = node->Cast<SelectNode>();
-		for (auto &expr : select.select_list) {
-			ExtractFunctionsFromExpression(expr.get(), functions);
-		}
-		if (select.where_clause) {
-			ExtractFunctionsFromExpression(select.where_clause.get(), functions);
-		}
-		for (auto &expr : select.groups.group_expressions) {
-			ExtractFunctionsFromExpression(expr.get(), functions);
+static void ExtractParameters(const FunctionData &bind_data, const ColumnProjection &projection, SQLStatement &stmt,
+                              idx_t stmt_index, SpanLocator &spans, vector<ParameterRow> &rows) {
+	QueryAnalysis analysis;
+	QueryAnalyzer analyzer(analysis, AnalysisTarget::PARAMETERS);
+	analyzer.VisitStatement(stmt);
+	bool locate = ProjectsSpan(projection, PARAMETER_SPAN_COLUMN);
+	for (auto &param : analysis.parameters) {
+		auto entry = stmt.named_param_map.find(param.name);
+		ParameterRow row;
+		row.stmt_index = stmt_index;
+		row.param_index = entry == stmt.named_param_map.end() ? 0 : entry->second;
+		row.name = param.name;
+		row.style = ParameterStyle(spans, param);
+		row.column = param.column;
+		if (locate && param.location.IsValid()) {
+			// the parameter is the '$' or '?' and the number or name right after it
+			auto location = param.location.GetIndex();
+			idx_t length = 1;
+			while (IsParameterNameChar(spans.At(location + length))) {
+				length++;
+			}
+			row.span = spans.RangeSpan(location, length);
 		}
+		rows.push_back(std::move(row));
 	}
 }
 
-static void ExtractFunctionsFromStatement(SQLStatement *stmt, vector<FunctionRef> &functions) {
-	if (!stmt) return;
-
-	if (stmt->type == StatementType::SELECT_STATEMENT) {
-		auto &select = stmt->Cast<SelectStatement>();
-		if (select.node) {
-			ExtractFunctionsFromQueryNode(select.node.get(), functions);
+static void WriteParameterRow(DataChunk &output, const ColumnProjection &projection, idx_t out_idx,
+                              const ParameterRow &row) {
+	for (idx_t col_idx = 0; col_idx < projection.columns.size(); col_idx++) {
+		auto &vector = output.data[col_idx];
+		switch (projection.columns[col_idx]) {
+		case 0:
+			vector.SetValue(out_idx, Value::BIGINT(row.stmt_index));
+			break;
+		case 1:
+			vector.SetValue(out_idx, row.param_index == 0 ? Value() : Value::BIGINT(row.param_index));
+			break;
+		case 2:
+			vector.SetValue(out_idx, Value(row.name));
+			break;
+		case 3:
+			vector.SetValue(out_idx, Value(row.style));
+			break;
+		case 4:
+			vector.SetValue(out_idx, row.column.empty() ? Value() : Value(row.column));
+			break;
+		default:
+			WriteSpanField(vector, projection.columns[col_idx] - PARAMETER_SPAN_COLUMN, out_idx, row.span);
+			break;
 		}
 	}
 }
 
-// ============================================================================
-// parse_functions(query) - Extract function calls
-// ============================================================================
-
-struct ParseFunctionsBindData : public TableFunctionData {
-	vector<FunctionRef> functions;
-	string error;
-};
-
-struct ParseFunctionsState : public GlobalTableFunctionState {
-	idx_t current_idx = 0;
-};
-
-static unique_ptr<FunctionData> ParseFunctionsBind(ClientContext &context, TableFunctionBindInput &input,
-                                                    vector<LogicalType> &return_types, vector<string> &names) {
-	auto result = make_uniq<ParseFunctionsBindData>();
-	string query = input.inputs[0].GetValue<string>();
-
-	try {
-		Parser parser;
-		parser.ParseQuery(query);
-		for (auto &stmt : parser.statements) {
-			ExtractFunctionsFromStatement(stmt.get(), result->functions);
-		}
-	} catch (const Exception &e) {
-		result->error = e.what();
+static unique_ptr<FunctionData> ParseParametersBind(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<ParseQueryBindData>();
+	result->limits = GetParseLimits(context);
+	if (!input.inputs.empty()) {
+		result->query = input.inputs[0].GetValue<string>();
 	}
 
+	return_types.push_back(LogicalType::BIGINT);
+	names.push_back("stmt_index");
+	return_types.push_back(LogicalType::BIGINT);
+	names.push_back("param_index");
 	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("function_name");
+	names.push_back("param_name");
 	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("function_type");
+	names.push_back("param_style");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("column_name");
+	AddSpanColumns(return_types, names);
 
 	return std::move(result);
 }
 
-static unique_ptr<GlobalTableFunctionState> ParseFunctionsInit(ClientContext &context, TableFunctionInitInput &input) {
-	return make_uniq<ParseFunctionsState>();
-}
-
-static void ParseFunctionsFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
-	auto &bind_data = data_p.bind_data->Cast<ParseFunctionsBindData>();
-	auto &state = data_p.global_state->Cast<ParseFunctionsState>();
-
-	idx_t count = 0;
-	while (state.current_idx < bind_data.functions.size() && count < STANDARD_VECTOR_SIZE) {
-		auto &f = bind_data.functions[state.current_idx];
-		output.data[0].SetValue(count, Value(f.name));
-		output.data[1].SetValue(count, Value(f.type));
-		count++;
-		state.current_idx++;
-	}
-	output.SetCardinality(count);
-}
-
-// ============================================================================
-// parse_function_names(query) - Returns function names as array
-// ============================================================================
-
-static void ParseFunctionNamesFunc(DataChunk &args, ExpressionState &state, Vector &result) {
-	UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(), [&](string_t query) {
-		vector<FunctionRef> functions;
-		try {
-			Parser parser;
-			parser.ParseQuery(query.GetString());
-			for (auto &stmt : parser.statements) {
-				ExtractFunctionsFromStatement(stmt.get(), functions);
-			}
-		} catch (...) {
+// num_parameters(query) - the number of values to bind, summed over the statements; 0 if the query does not parse.
+// A query without a '$' or '?' byte has no parameters and is not parsed.
+static void NumParametersFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto cache = GetParseCache(state);
+	UnaryExecutor::Execute<string_t, int64_t>(args.data[0], result, args.size(), [&](string_t query) {
+		auto data = query.GetData();
+		auto size = query.GetSize();
+		if (!memchr(data, '$', size) && !memchr(data, '?', size)) {
+			return static_cast<int64_t>(0);
 		}
-
-		auto &child = ListVector::GetEntry(result);
-		auto current_size = ListVector::GetListSize(result);
-
-		for (auto &f : functions) {
-			child.SetValue(current_size++, Value(f.name));
+		auto parsed = cache.GetOrParse(query);
+		idx_t count = 0;
+		for (auto &stmt : parsed->statements) {
+			count += StatementParamCount(*stmt);
 		}
-		ListVector::SetListSize(result, current_size);
-
-		return list_entry_t{current_size - functions.size(), functions.size()};
+		return static_cast<int64_t>(count);
 	});
 }
 
 // ============================================================================
-// Helper: Extract WHERE conditions
+// sql_parse_json(query) - Get parse info as JSON
 // ============================================================================
 
-struct WhereCondition {
-	string column_name;
-	string op;
-	string value;
-};
+// The JSON is produced by running the same writer calls twice: JsonSizeWriter measures the exact size of the result,
+// then JsonBufferWriter writes it straight into the result string. Strings are escaped in runs: a word at a time
+// is skipped over bytes that need no escaping, and whole runs are copied at once.
 
-static string ComparisonTypeToOperator(ExpressionType type) {
-	switch (type) {
-	case ExpressionType::COMPARE_EQUAL: return "=";
-	case ExpressionType::COMPARE_NOTEQUAL: return "!=";
-	case ExpressionType::COMPARE_LESSTHAN: return "<";
-	case ExpressionType::COMPARE_GREATERTHAN: return ">";
-	case ExpressionType::COMPARE_LESSTHANOREQUALTO: return "<=";
-	case ExpressionType::COMPARE_GREATERTHANOREQUALTO: return ">=";
-	case ExpressionType::COMPARE_IN: return "IN";
-	case ExpressionType::COMPARE_NOT_IN: return "NOT IN";
-	default: return "?";
-	}
+static inline bool NeedsJsonEscape(unsigned char c) {
+	return c == '"' || c == '\\' || c < 0x20;
 }
 
-static void ExtractWhereConditions(ParsedExpression *expr, vector<WhereCondition> &conditions) {
-	if (!expr) return;
+// Whether any byte of word is a quote, a backslash or a control character
+static inline bool WordNeedsJsonEscape(uint64_t word) {
+	return WordHasByte(word, SWAR_ONES * '"') || WordHasByte(word, SWAR_ONES * '\\') ||
+	       ((word - SWAR_ONES * 0x20) & ~word & SWAR_HIGH_BITS) != 0;
+}
 
-	if (expr->type == ExpressionType::CONJUNCTION_AND || expr->type == ExpressionType::CONJUNCTION_OR) {
-		auto &conj = expr->Cast<ConjunctionExpression>();
-		for (auto &child : conj.children) {
-			ExtractWhereConditions(child.get(), conditions);
+// Returns the position of the first byte at or after pos that needs escaping, or size
+static idx_t FindJsonEscape(const char *data, idx_t pos, idx_t size) {
+	while (pos + sizeof(uint64_t) <= size) {
+		uint64_t word;
+		memcpy(&word, data + pos, sizeof(uint64_t));
+		if (WordNeedsJsonEscape(word)) {
+			break;
 		}
-		return;
+		pos += sizeof(uint64_t);
 	}
-
-	if (expr->GetExpressionClass() == ExpressionClass::COMPARISON) {
-		auto &cmp = expr->Cast<ComparisonExpression>();
-		WhereCondition cond;
-		cond.op = ComparisonTypeToOperator(cmp.type);
-
-		// Try to get column name from left side
-		if (cmp.left && cmp.left->type == ExpressionType::COLUMN_REF) {
-			auto &col = cmp.left->Cast<ColumnRefExpression>();
-			cond.column_name = col.GetColumnName();
-		} else if (cmp.left) {
-			cond.column_name = cmp.left->ToString();
+	for (; pos < size; pos++) {
+		if (NeedsJsonEscape(static_cast<unsigned char>(data[pos]))) {
+			return pos;
 		}
+	}
+	return size;
+}
 
-		// Try to get value from right side
-		if (cmp.right && cmp.right->type == ExpressionType::VALUE_CONSTANT) {
-			auto &val = cmp.right->Cast<ConstantExpression>();
-			cond.value = val.value.ToString();
-		} else if (cmp.right) {
-			cond.value = cmp.right->ToString();
-		}
+static idx_t JsonEscapeLength(char c) {
+	return c == '"' || c == '\\' || c == '\n' || c == '\r' || c == '\t' ? 2 : 6;
+}
 
-		conditions.push_back(cond);
+static char *WriteJsonEscape(char c, char *out) {
+	static constexpr const char *HEX_DIGITS = "0123456789abcdef";
+	*out++ = '\\';
+	switch (c) {
+	case '"':
+		*out++ = '"';
+		break;
+	case '\\':
+		*out++ = '\\';
+		break;
+	case '\n':
+		*out++ = 'n';
+		break;
+	case '\r':
+		*out++ = 'r';
+		break;
+	case '\t':
+		*out++ = 't';
+		break;
+	default:
+		*out++ = 'u';
+		*out++ = '0';
+		*out++ = '0';
+		*out++ = HEX_DIGITS[(static_cast<unsigned char>(c) >> 4) & 0xF];
+		*out++ = HEX_DIGITS[static_cast<unsigned char>(c) & 0xF];
+		break;
 	}
+	return out;
 }
 
-// ============================================================================
-// parse_where(query) - Extract WHERE clause conditions
-// ============================================================================
+struct JsonSizeWriter {
+	idx_t size = 0;
 
-struct ParseWhereBindData : public TableFunctionData {
-	vector<WhereCondition> conditions;
-	string error;
+	void Raw(const char *data, idx_t length) {
+		size += length;
+	}
+	void Escaped(const char *data, idx_t length) {
+		size += length;
+		for (auto pos = FindJsonEscape(data, 0, length); pos < length; pos = FindJsonEscape(data, pos + 1, length)) {
+			size += JsonEscapeLength(data[pos]) - 1;
+		}
+	}
 };
 
-struct ParseWhereState : public GlobalTableFunctionState {
-	idx_t current_idx = 0;
-};
+struct JsonBufferWriter {
+	explicit JsonBufferWriter(char *out) : out(out) {
+	}
 
-static unique_ptr<FunctionData> ParseWhereBind(ClientContext &context, TableFunctionBindInput &input,
-                                                vector<LogicalType> &return_types, vector<string> &names) {
-	auto result = make_uniq<ParseWhereBindData>();
-	string query = input.inputs[0].GetValue<string>();
+	char *out;
 
-	try {
-		Parser parser;
-		parser.ParseQuery(query);
-		for (auto &stmt : parser.statements) {
-			if (stmt->type == StatementType::SELECT_STATEMENT) {
-				auto &select = stmt->Cast<SelectStatement>();
-				if (select.node && select.node->type == QueryNodeType::SELECT_NODE) {
-					auto &snode = select.node->Cast<SelectNode>();
-					if (snode.where_clause) {
-						ExtractWhereConditions(snode.where_clause.get(), result->conditions);
-					}
-				}
-			}
+	void Raw(const char *data, idx_t length) {
+		memcpy(out, data, length);
+		out += length;
+	}
+	void Escaped(const char *data, idx_t length) {
+		idx_t run_start = 0;
+		for (auto pos = FindJsonEscape(data, 0, length); pos < length; pos = FindJsonEscape(data, run_start, length)) {
+			Raw(data + run_start, pos - run_start);
+			out = WriteJsonEscape(data[pos], out);
+			run_start = pos + 1;
 		}
-	} catch (const Exception &e) {
-		result->error = e.what();
+		Raw(data + run_start, length - run_start);
 	}
+};
 
-	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("column_name");
-	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("operator");
-	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("value");
-
-	return std::move(result);
-}
-
-static unique_ptr<GlobalTableFunctionState> ParseWhereInit(ClientContext &context, TableFunctionInitInput &input) {
-	return make_uniq<ParseWhereState>();
+template <class WRITER>
+static void WriteJsonLiteral(WRITER &writer, const char *text) {
+	writer.Raw(text, strlen(text));
 }
 
-static void ParseWhereFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
-	auto &bind_data = data_p.bind_data->Cast<ParseWhereBindData>();
-	auto &state = data_p.global_state->Cast<ParseWhereState>();
-
-	idx_t count = 0;
-	while (state.current_idx < bind_data.conditions.size() && count < STANDARD_VECTOR_SIZE) {
-		auto &c = bind_data.conditions[state.current_idx];
-		output.data[0].SetValue(count, Value(c.column_name));
-		output.data[1].SetValue(count, Value(c.op));
-		output.data[2].SetValue(count, Value(c.value));
-		count++;
-		state.current_idx++;
+// Write the parse info of a query: the statement types and, if queries is not null, the re-serialized statements
+template <class WRITER>
+static void WriteParseJson(WRITER &writer, const ParsedQuery &parsed, const vector<string> *queries,
+                           const string &error) {
+	if (!error.empty()) {
+		WriteJsonLiteral(writer, "{\"error\":true,\"error_message\":\"");
+		writer.Escaped(error.data(), error.size());
+		WriteJsonLiteral(writer, "\"}");
+		return;
 	}
-	output.SetCardinality(count);
+	WriteJsonLiteral(writer, "{\"error\":false,\"statements\":[");
+	for (idx_t i = 0; i < parsed.statements.size(); i++) {
+		WriteJsonLiteral(writer, i == 0 ? "{\"type\":\"" : ",{\"type\":\"");
+		auto type = StatementTypeToString(parsed.statements[i]->type);
+		writer.Raw(type.data(), type.size());
+		if (queries) {
+			auto &query = (*queries)[i];
+			WriteJsonLiteral(writer, "\",\"query\":\"");
+			writer.Escaped(query.data(), query.size());
+		}
+		WriteJsonLiteral(writer, "\"}");
+	}
+	WriteJsonLiteral(writer, "]}");
 }
 
-// ============================================================================
-// sql_strip_comments(query) - Remove comments from SQL
-// ============================================================================
-
-static void SqlStripCommentsFunc(DataChunk &args, ExpressionState &state, Vector &result) {
-	UnaryExecutor::Execute<string_t, string_t>(args.data[0], result, args.size(), [&](string_t query) {
-		string input = query.GetString();
-		string output;
-		output.reserve(input.size());
-
-		bool in_line_comment = false;
-		bool in_block_comment = false;
-		bool in_string = false;
-		char string_char = 0;
-
-		for (size_t i = 0; i < input.size(); i++) {
-			char c = input[i];
-			char next = (i + 1 < input.size()) ? input[i + 1] : 0;
-
-			if (in_line_comment) {
-				if (c == '\n') {
-					in_line_comment = false;
-					output += c;
-				}
-				continue;
-			}
-
-			if (in_block_comment) {
-				if (c == '*' && next == '/') {
-					in_block_comment = false;
-					i++; // skip the /
-				}
-				continue;
-			}
-
-			if (in_string) {
-				output += c;
-				if (c == string_char && (i + 1 >= input.size() || input[i + 1] != string_char)) {
-					in_string = false;
-				} else if (c == string_char) {
-					output += input[++i]; // escaped quote
+// parse_sql_json(query [, include_query]) - include_query (default true) re-serializes every statement, which costs
+// more than the parse itself; without it only the statement types are written
+static void SqlParseJsonFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto cache = GetParseCache(state);
+	vector<string> queries;
+	auto parse_json = [&](string_t query, bool include_query) {
+		auto parsed = cache.GetOrParse(query);
+		string error = parsed->success ? string() : parsed->error;
+		queries.clear();
+		if (error.empty() && include_query) {
+			try {
+				for (auto &stmt : parsed->statements) {
+					queries.push_back(stmt->ToString());
 				}
-				continue;
-			}
-
-			// Check for comment start
-			if (c == '-' && next == '-') {
-				in_line_comment = true;
-				i++; // skip second -
-				continue;
-			}
-
-			if (c == '/' && next == '*') {
-				in_block_comment = true;
-				i++; // skip *
-				continue;
+			} catch (const Exception &e) {
+				PoachedStats::Add(PoachedStat::EXCEPTIONS);
+				error = e.what();
 			}
-
-			// Check for string start
-			if (c == '\'' || c == '"') {
-				in_string = true;
-				string_char = c;
-			}
-
-			output += c;
 		}
+		auto query_strings = include_query ? &queries : nullptr;
+
+		JsonSizeWriter size;
+		WriteParseJson(size, *parsed, query_strings, error);
+		auto json = StringVector::EmptyString(result, size.size);
+		JsonBufferWriter writer(json.GetDataWriteable());
+		WriteParseJson(writer, *parsed, query_strings, error);
+		json.Finalize();
+		return json;
+	};
 
-		return StringVector::AddString(result, output);
-	});
+	if (args.ColumnCount() == 1) {
+		UnaryExecutor::Execute<string_t, string_t>(args.data[0], result, args.size(),
+		                                           [&](string_t query) { return parse_json(query, true); });
+	} else {
+		BinaryExecutor::Execute<string_t, bool, string_t>(args.data[0], args.data[1], result, args.size(), parse_json);
+	}
 }
 
 // ============================================================================
-// parse_columns(query, stmt_index) - Get SELECT column names
+// poached_parse_cache_stats() - Inspect the shared parse cache
 // ============================================================================
 
-struct ParseColumnsBindData : public TableFunctionData {
-	vector<string> col_names;
-	string error;
+struct ParseCacheStatsState : public GlobalTableFunctionState {
+	bool finished = false;
 };
 
-struct ParseColumnsState : public GlobalTableFunctionState {
-	idx_t current_idx = 0;
-};
+static unique_ptr<FunctionData> ParseCacheStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+	return_types.push_back(LogicalType::UBIGINT);
+	names.push_back("capacity");
+	return_types.push_back(LogicalType::UBIGINT);
+	names.push_back("entries");
+	return_types.push_back(LogicalType::UBIGINT);
+	names.push_back("hits");
+	return_types.push_back(LogicalType::UBIGINT);
+	names.push_back("misses");
+
+	return make_uniq<TableFunctionData>();
+}
 
-static string GetExpressionName(ParsedExpression *expr) {
-	if (!expr) return "";
+static unique_ptr<GlobalTableFunctionState> ParseCacheStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<ParseCacheStatsState>();
+}
 
-	// If there's an alias, use it
-	if (!expr->alias.empty()) {
-		return expr->alias;
+static void ParseCacheStatsFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &state = data_p.global_state->Cast<ParseCacheStatsState>();
+	if (state.finished) {
+		return;
 	}
+	auto &cache = ParseCache::Get();
+	output.data[0].SetValue(0, Value::UBIGINT(cache.Capacity()));
+	output.data[1].SetValue(0, Value::UBIGINT(cache.Size()));
+	output.data[2].SetValue(0, Value::UBIGINT(cache.Hits()));
+	output.data[3].SetValue(0, Value::UBIGINT(cache.Misses()));
+	output.SetCardinality(1);
+	state.finished = true;
+}
 
-	// Otherwise, generate a name based on expression type
-	switch (expr->type) {
-	case ExpressionType::COLUMN_REF: {
-		auto &col = expr->Cast<ColumnRefExpression>();
-		return col.GetColumnName();
-	}
-	case ExpressionType::FUNCTION: {
-		auto &fn = expr->Cast<FunctionExpression>();
-		return fn.function_name;
+// ============================================================================
+// poached_stats() - Per-function counters, see PoachedStats
+// ============================================================================
+//
+// The wrappers below make the function current on the thread for the duration of its callbacks, so that parse
+// times, cache lookups and exceptions deeper down are counted for it, and count its calls and rows.
+
+// Bytes of the VARCHAR query argument of a scalar function call
+static idx_t ScalarBytesIn(DataChunk &args) {
+	if (args.ColumnCount() == 0 || args.data[0].GetType().id() != LogicalTypeId::VARCHAR) {
+		return 0;
 	}
-	default:
-		return expr->ToString();
+	auto count = args.size();
+	UnifiedVectorFormat vdata;
+	args.data[0].ToUnifiedFormat(count, vdata);
+	auto strings = UnifiedVectorFormat::GetData<string_t>(vdata);
+	idx_t bytes = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		if (vdata.validity.RowIsValid(idx)) {
+			bytes += strings[idx].GetSize();
+		}
 	}
+	return bytes;
 }
 
-static unique_ptr<FunctionData> ParseColumnsBind(ClientContext &context, TableFunctionBindInput &input,
-                                                  vector<LogicalType> &return_types, vector<string> &names) {
-	auto result = make_uniq<ParseColumnsBindData>();
-	string query = input.inputs[0].GetValue<string>();
-	idx_t stmt_index = input.inputs[1].GetValue<int64_t>();
+template <PoachedFunction FUNCTION, void (*FUNC)(DataChunk &args, ExpressionState &state, Vector &result)>
+static void InstrumentedScalar(DataChunk &args, ExpressionState &state, Vector &result) {
+	PoachedStatsScope scope(FUNCTION);
+	if (PoachedStats::ENABLED) {
+		PoachedStats::Add(PoachedStat::CALLS);
+		PoachedStats::Add(PoachedStat::ROWS, args.size());
+		PoachedStats::Add(PoachedStat::BYTES_IN, ScalarBytesIn(args));
+	}
+	FUNC(args, state, result);
+}
 
-	try {
-		Parser parser;
-		parser.ParseQuery(query);
-
-		if (stmt_index < parser.statements.size()) {
-			auto &stmt = parser.statements[stmt_index];
-			if (stmt->type == StatementType::SELECT_STATEMENT) {
-				auto &select = stmt->Cast<SelectStatement>();
-				if (select.node && select.node->type == QueryNodeType::SELECT_NODE) {
-					auto &snode = select.node->Cast<SelectNode>();
-					for (auto &expr : snode.select_list) {
-						result->col_names.push_back(GetExpressionName(expr.get()));
-					}
-				}
-			}
-		}
-	} catch (const Exception &e) {
-		result->error = e.what();
+// Table functions take the bytes of a constant query argument in at bind time. QUERY_ARGUMENT is false for functions
+// whose first argument is not query text.
+template <PoachedFunction FUNCTION, table_function_bind_t BIND, bool QUERY_ARGUMENT = true>
+static unique_ptr<FunctionData> InstrumentedBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	PoachedStatsScope scope(FUNCTION);
+	if (QUERY_ARGUMENT && !input.inputs.empty() && input.inputs[0].type().id() == LogicalTypeId::VARCHAR &&
+	    !input.inputs[0].IsNull()) {
+		PoachedStats::Add(PoachedStat::BYTES_IN, StringValue::Get(input.inputs[0]).size());
 	}
+	return BIND(context, input, return_types, names);
+}
 
-	return_types.push_back(LogicalType::BIGINT);
-	names.push_back("col_index");
-	return_types.push_back(LogicalType::VARCHAR);
-	names.push_back("col_name");
+// A constant query is split into statements in the global init, which is counted in the function's time
+template <PoachedFunction FUNCTION, table_function_init_global_t INIT>
+static unique_ptr<GlobalTableFunctionState> InstrumentedInit(ClientContext &context, TableFunctionInitInput &input) {
+	PoachedStatsScope scope(FUNCTION);
+	return INIT(context, input);
+}
 
-	return std::move(result);
+template <PoachedFunction FUNCTION, table_function_t FUNC>
+static void InstrumentedTable(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	PoachedStatsScope scope(FUNCTION);
+	FUNC(context, data_p, output);
+	PoachedStats::Add(PoachedStat::CALLS);
+	PoachedStats::Add(PoachedStat::ROWS, output.size());
 }
 
-static unique_ptr<GlobalTableFunctionState> ParseColumnsInit(ClientContext &context, TableFunctionInitInput &input) {
-	return make_uniq<ParseColumnsState>();
+template <PoachedFunction FUNCTION, table_in_out_function_t FUNC>
+static OperatorResultType InstrumentedInOut(ExecutionContext &context, TableFunctionInput &data_p, DataChunk &input,
+                                            DataChunk &output) {
+	PoachedStatsScope scope(FUNCTION);
+	auto result = FUNC(context, data_p, input, output);
+	PoachedStats::Add(PoachedStat::CALLS);
+	PoachedStats::Add(PoachedStat::ROWS, output.size());
+	return result;
+}
+
+struct PoachedStatsState : public GlobalTableFunctionState {
+	vector<poached_counters_t> counters;
+	idx_t current_idx = 0;
+};
+
+static unique_ptr<FunctionData> PoachedStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	return_types.push_back(LogicalType::VARCHAR);
+	names.push_back("function_name");
+	for (idx_t s = 0; s < POACHED_STAT_COUNT; s++) {
+		return_types.push_back(LogicalType::UBIGINT);
+		names.push_back(PoachedStats::StatName(static_cast<PoachedStat>(s)));
+	}
+	return make_uniq<TableFunctionData>();
 }
 
-static void ParseColumnsFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
-	auto &bind_data = data_p.bind_data->Cast<ParseColumnsBindData>();
-	auto &state = data_p.global_state->Cast<ParseColumnsState>();
+static unique_ptr<GlobalTableFunctionState> PoachedStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<PoachedStatsState>();
+	result->counters = PoachedStats::Snapshot();
+	return std::move(result);
+}
 
+static void PoachedStatsFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &state = data_p.global_state->Cast<PoachedStatsState>();
 	idx_t count = 0;
-	while (state.current_idx < bind_data.col_names.size() && count < STANDARD_VECTOR_SIZE) {
-		output.data[0].SetValue(count, Value::BIGINT(state.current_idx));
-		output.data[1].SetValue(count, Value(bind_data.col_names[state.current_idx]));
+	while (state.current_idx < state.counters.size() && count < STANDARD_VECTOR_SIZE) {
+		auto function = static_cast<PoachedFunction>(state.current_idx);
+		output.data[0].SetValue(count, Value(PoachedStats::FunctionName(function)));
+		auto &counters = state.counters[state.current_idx];
+		for (idx_t s = 0; s < POACHED_STAT_COUNT; s++) {
+			output.data[1 + s].SetValue(count, Value::UBIGINT(counters[s]));
+		}
 		count++;
 		state.current_idx++;
 	}
 	output.SetCardinality(count);
 }
 
-// ============================================================================
-// parse_column_names(query, stmt_index) - Get SELECT column names as array
-// ============================================================================
-
-static void ParseColumnNamesFunc(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &query_vec = args.data[0];
-	auto &idx_vec = args.data[1];
-	auto &child = ListVector::GetEntry(result);
-	idx_t current_size = ListVector::GetListSize(result);
-
-	BinaryExecutor::Execute<string_t, int64_t, list_entry_t>(query_vec, idx_vec, result, args.size(),
-	                                                        [&](string_t query, int64_t stmt_index) {
-		                                                        vector<string> col_names;
-		                                                        try {
-			                                                        if (stmt_index >= 0) {
-				                                                        Parser parser;
-				                                                        parser.ParseQuery(query.GetString());
-				                                                        auto idx = static_cast<idx_t>(stmt_index);
-				                                                        if (idx < parser.statements.size()) {
-					                                                        auto &stmt = parser.statements[idx];
-					                                                        if (stmt->type == StatementType::SELECT_STATEMENT) {
-						                                                        auto &select = stmt->Cast<SelectStatement>();
-						                                                        if (select.node && select.node->type == QueryNodeType::SELECT_NODE) {
-							                                                        auto &snode = select.node->Cast<SelectNode>();
-							                                                        for (auto &expr : snode.select_list) {
-								                                                        col_names.push_back(GetExpressionName(expr.get()));
-							                                                        }
-						                                                        }
-					                                                        }
-				                                                        }
-			                                                        }
-		                                                        } catch (...) {
-		                                                        }
-
-		                                                        if (!col_names.empty()) {
-			                                                        ListVector::Reserve(result, current_size + col_names.size());
-			                                                        for (auto &name : col_names) {
-				                                                        child.SetValue(current_size++, Value(name));
-			                                                        }
-		                                                        }
-
-		                                                        return list_entry_t{current_size - col_names.size(), col_names.size()};
-	                                                        });
-
-	ListVector::SetListSize(result, current_size);
+// poached_stats_reset() - start counting from zero, returns true
+static void PoachedStatsResetFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	PoachedStats::Reset();
+	result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	ConstantVector::GetData<bool>(result)[0] = true;
 }
 
 // ============================================================================
-// sql_parse_json(query) - Get parse info as JSON
+// Registration
 // ============================================================================
 
-static string EscapeJsonString(const string &s) {
-	string result;
-	result.reserve(s.size());
-	for (char c : s) {
-		switch (c) {
-		case '"': result += "\\\""; break;
-		case '\\': result += "\\\\"; break;
-		case '\n': result += "\\n"; break;
-		case '\r': result += "\\r"; break;
-		case '\t': result += "\\t"; break;
-		default: result += c; break;
-		}
+// The in-out callback of a table function whose COLLECT fills the ROWs of an input row, as a class so that the
+// registration can name it through a local alias
+template <class ROW,
+          void (*COLLECT)(const FunctionData &bind_data, const ColumnProjection &projection, DataChunk &input,
+                          const UnifiedVectorFormat &query_data, idx_t row_idx, vector<ROW> &rows),
+          void (*WRITE)(DataChunk &output, const ColumnProjection &projection, idx_t out_idx, const ROW &row)>
+struct InOutCallbacks {
+	static OperatorResultType InOut(ExecutionContext &context, TableFunctionInput &data_p, DataChunk &input,
+	                                DataChunk &output) {
+		return ParseInOutFunction<ROW, COLLECT, WRITE>(context, data_p, input, output);
 	}
-	return result;
-}
-
-static void SqlParseJsonFunc(DataChunk &args, ExpressionState &state, Vector &result) {
-	UnaryExecutor::Execute<string_t, string_t>(args.data[0], result, args.size(), [&](string_t query) {
-		try {
-			Parser parser;
-			parser.ParseQuery(query.GetString());
-
-			std::ostringstream json;
-			json << "{\"error\":false,\"statements\":[";
-
-			bool first = true;
-			for (auto &stmt : parser.statements) {
-				if (!first) json << ",";
-				first = false;
+};
 
-				json << "{\"type\":\"" << StatementTypeToString(stmt->type) << "\"";
-				json << ",\"query\":\"" << EscapeJsonString(stmt->ToString()) << "\"}";
-			}
+// The scan and in-out callbacks of a table function EXTRACTing ROWs from every statement of a query
+template <class ROW,
+          void (*EXTRACT)(const FunctionData &bind_data, const ColumnProjection &projection, SQLStatement &stmt,
+                          idx_t stmt_index, SpanLocator &spans, vector<ROW> &rows),
+          void (*WRITE)(DataChunk &output, const ColumnProjection &projection, idx_t out_idx, const ROW &row)>
+struct ExtractionCallbacks : public InOutCallbacks<ROW, ParseQueryInOutCollect<ROW, EXTRACT>, WRITE> {
+	static void Scan(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+		ParseQueryScanFunc<ROW, EXTRACT, WRITE>(context, data_p, output);
+	}
+};
 
-			json << "]}";
-			return StringVector::AddString(result, json.str());
-		} catch (const Exception &e) {
-			std::ostringstream json;
-			json << "{\"error\":true,\"error_message\":\"" << EscapeJsonString(e.what()) << "\"}";
-			return StringVector::AddString(result, json.str());
-		}
-	});
+// The overloads of parse_sql_json and its alias sql_parse_json
+template <PoachedFunction FUNCTION>
+static ScalarFunctionSet ParseSqlJsonFunctions(const string &name) {
+	ScalarFunctionSet parse_sql_json(name);
+	parse_sql_json.AddFunction(ScalarFunction({LogicalType::VARCHAR}, LogicalType::VARCHAR,
+	                                          InstrumentedScalar<FUNCTION, ExecuteDistinct<SqlParseJsonFunc>>));
+	parse_sql_json.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::BOOLEAN}, LogicalType::VARCHAR,
+	                                          InstrumentedScalar<FUNCTION, ExecuteDistinct<SqlParseJsonFunc>>));
+	return parse_sql_json;
 }
 
-// ============================================================================
-// Registration
-// ============================================================================
-
 void RegisterParserFunctions(ExtensionLoader &loader) {
-	// Table functions
-	TableFunction tokenize_sql("tokenize_sql", {LogicalType::VARCHAR}, TokenizeSqlFunc, TokenizeSqlBind, TokenizeSqlInit);
+	// Settings
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption("poached_parse_cache_size",
+	                          "Maximum number of parsed queries kept in the parse cache shared by the poached scalar "
+	                          "functions (0 disables the cache)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(ParseCache::DEFAULT_CAPACITY), SetParseCacheSize);
+	config.AddExtensionOption("poached_max_query_bytes",
+	                          "Queries longer than this many bytes are not parsed but give an error (0 is no limit)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(0));
+	config.AddExtensionOption("poached_max_nesting_depth",
+	                          "Queries nesting parentheses, brackets and CASE deeper than this are not parsed but give "
+	                          "an error (0 is no limit)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(0));
+	config.AddExtensionOption("poached_max_query_tokens",
+	                          "Queries of more than this many tokens are not parsed but give an error (0 is no limit)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(0));
+
+	// Table functions, each with an in-out variant for column (LATERAL) inputs
+	using TokenCallbacks = InOutCallbacks<TokenRow, TokenizeSqlInOutCollect, WriteTokenRow>;
+	using StatementCallbacks = InOutCallbacks<StatementRow, ParseStatementsInOutCollect, WriteStatementRow>;
+	using TableCallbacks = ExtractionCallbacks<ExtractedTable, ExtractTables, WriteTableRow>;
+	using FunctionCallbacks = ExtractionCallbacks<FunctionRef, ExtractFunctions, WriteFunctionRow>;
+	using WhereCallbacks = ExtractionCallbacks<WhereCondition, ExtractConditions, WriteWhereRow>;
+	using ColumnScanCallbacks = ExtractionCallbacks<ColumnRow, ExtractColumns, WriteColumnRow>;
+	using ColumnInOutCallbacks = InOutCallbacks<ColumnRow, ParseColumnsInOutCollect, WriteColumnRow>;
+	using LineageCallbacks = ExtractionCallbacks<LineageRow, ExtractLineage, WriteLineageRow>;
+	using ParameterCallbacks = ExtractionCallbacks<ParameterRow, ExtractParameters, WriteParameterRow>;
+
+	TableFunction tokenize_sql("tokenize_sql", {LogicalType::VARCHAR},
+	                           InstrumentedTable<PoachedFunction::TOKENIZE_SQL, TokenizeSqlFunc>,
+	                           InstrumentedBind<PoachedFunction::TOKENIZE_SQL, TokenizeSqlBind>, TokenizeSqlInit);
+	tokenize_sql.in_out_function = InstrumentedInOut<PoachedFunction::TOKENIZE_SQL, TokenCallbacks::InOut>;
+	tokenize_sql.init_local = ParseInOutInitLocal<TokenRow>;
+	tokenize_sql.projection_pushdown = true;
 	loader.RegisterFunction(tokenize_sql);
 
-	TableFunction parse_tokens("parse_tokens", {LogicalType::VARCHAR}, TokenizeSqlFunc, TokenizeSqlBind, TokenizeSqlInit);
+	TableFunction parse_tokens("parse_tokens", {LogicalType::VARCHAR},
+	                           InstrumentedTable<PoachedFunction::PARSE_TOKENS, TokenizeSqlFunc>,
+	                           InstrumentedBind<PoachedFunction::PARSE_TOKENS, TokenizeSqlBind>, TokenizeSqlInit);
+	parse_tokens.in_out_function = InstrumentedInOut<PoachedFunction::PARSE_TOKENS, TokenCallbacks::InOut>;
+	parse_tokens.init_local = ParseInOutInitLocal<TokenRow>;
+	parse_tokens.projection_pushdown = true;
 	loader.RegisterFunction(parse_tokens);
 
-	TableFunction sql_keywords("sql_keywords", {}, SqlKeywordsFunc, SqlKeywordsBind, SqlKeywordsInit);
+	TableFunction sql_keywords("sql_keywords", {}, InstrumentedTable<PoachedFunction::SQL_KEYWORDS, SqlKeywordsFunc>,
+	                           InstrumentedBind<PoachedFunction::SQL_KEYWORDS, SqlKeywordsBind>, SqlKeywordsInit);
 	loader.RegisterFunction(sql_keywords);
 
-	TableFunction parse_keywords("parse_keywords", {}, SqlKeywordsFunc, SqlKeywordsBind, SqlKeywordsInit);
+	TableFunction parse_keywords("parse_keywords", {},
+	                             InstrumentedTable<PoachedFunction::PARSE_KEYWORDS, SqlKeywordsFunc>,
+	                             InstrumentedBind<PoachedFunction::PARSE_KEYWORDS, SqlKeywordsBind>, SqlKeywordsInit);
 	loader.RegisterFunction(parse_keywords);
 
-	TableFunction parse_statements("parse_statements", {LogicalType::VARCHAR}, ParseStatementsFunc, ParseStatementsBind, ParseStatementsInit);
+	TableFunction parse_statements("parse_statements", {LogicalType::VARCHAR},
+	                               InstrumentedTable<PoachedFunction::PARSE_STATEMENTS, ParseStatementsFunc>,
+	                               InstrumentedBind<PoachedFunction::PARSE_STATEMENTS, ParseStatementsBind>,
+	                               InstrumentedInit<PoachedFunction::PARSE_STATEMENTS, ParseStatementsInit>);
+	parse_statements.in_out_function = InstrumentedInOut<PoachedFunction::PARSE_STATEMENTS, StatementCallbacks::InOut>;
+	parse_statements.init_local = ParseStatementsInitLocal;
+	parse_statements.get_partition_data = ParseStatementsGetPartitionData;
+	parse_statements.projection_pushdown = true;
+	parse_statements.pushdown_complex_filter = ParsePushdownFilter<STATEMENT_TYPE_COLUMN>;
 	loader.RegisterFunction(parse_statements);
 
-	TableFunction parse_tables("parse_tables", {LogicalType::VARCHAR}, ParseTablesFunc, ParseTablesBind, ParseTablesInit);
+	TableFunction parse_sql_file(
+	    "parse_sql_file", {LogicalType::VARCHAR},
+	    InstrumentedTable<PoachedFunction::PARSE_SQL_FILE,
+	                      ParseSqlFileFunc<StatementRow, CollectFileStatements, WriteFileStatementRow>>,
+	    InstrumentedBind<PoachedFunction::PARSE_SQL_FILE, ParseSqlFileBind, false>, ParseSqlFileInit,
+	    ParseSqlFileInitLocal<StatementRow>);
+	parse_sql_file.get_partition_data = ParseSqlFileGetPartitionData<StatementRow>;
+	parse_sql_file.projection_pushdown = true;
+	parse_sql_file.pushdown_complex_filter = ParsePushdownFilter<FILE_COLUMN_OFFSET + STATEMENT_TYPE_COLUMN>;
+	loader.RegisterFunction(parse_sql_file);
+
+	TableFunction parse_sql_file_tables(
+	    "parse_sql_file_tables", {LogicalType::VARCHAR},
+	    InstrumentedTable<PoachedFunction::PARSE_SQL_FILE_TABLES,
+	                      ParseSqlFileFunc<FileTableRow, CollectFileTables, WriteFileTableRow>>,
+	    InstrumentedBind<PoachedFunction::PARSE_SQL_FILE_TABLES, ParseSqlFileTablesBind, false>, ParseSqlFileInit,
+	    ParseSqlFileInitLocal<FileTableRow>);
+	parse_sql_file_tables.get_partition_data = ParseSqlFileGetPartitionData<FileTableRow>;
+	parse_sql_file_tables.projection_pushdown = true;
+	parse_sql_file_tables.pushdown_complex_filter = ParsePushdownFilter<FILE_COLUMN_OFFSET + TABLE_CONTEXT_COLUMN>;
+	loader.RegisterFunction(parse_sql_file_tables);
+
+	TableFunction parse_tables("parse_tables", {LogicalType::VARCHAR},
+	                           InstrumentedTable<PoachedFunction::PARSE_TABLES, TableCallbacks::Scan>,
+	                           InstrumentedBind<PoachedFunction::PARSE_TABLES, ParseTablesBind>,
+	                           InstrumentedInit<PoachedFunction::PARSE_TABLES, ParseQueryScanInit<ExtractedTable>>);
+	parse_tables.in_out_function = InstrumentedInOut<PoachedFunction::PARSE_TABLES, TableCallbacks::InOut>;
+	parse_tables.init_local = ParseInOutInitLocal<ExtractedTable>;
+	parse_tables.projection_pushdown = true;
+	parse_tables.pushdown_complex_filter = ParsePushdownFilter<TABLE_CONTEXT_COLUMN>;
 	loader.RegisterFunction(parse_tables);
 
-	TableFunction parse_functions("parse_functions", {LogicalType::VARCHAR}, ParseFunctionsFunc, ParseFunctionsBind, ParseFunctionsInit);
+	TableFunction parse_functions("parse_functions", {LogicalType::VARCHAR},
+	                              InstrumentedTable<PoachedFunction::PARSE_FUNCTIONS, FunctionCallbacks::Scan>,
+	                              InstrumentedBind<PoachedFunction::PARSE_FUNCTIONS, ParseFunctionsBind>,
+	                              InstrumentedInit<PoachedFunction::PARSE_FUNCTIONS, ParseQueryScanInit<FunctionRef>>);
+	parse_functions.in_out_function = InstrumentedInOut<PoachedFunction::PARSE_FUNCTIONS, FunctionCallbacks::InOut>;
+	parse_functions.init_local = ParseInOutInitLocal<FunctionRef>;
+	parse_functions.projection_pushdown = true;
+	parse_functions.pushdown_complex_filter = ParsePushdownFilter<FUNCTION_TYPE_COLUMN>;
 	loader.RegisterFunction(parse_functions);
 
-	TableFunction parse_where("parse_where", {LogicalType::VARCHAR}, ParseWhereFunc, ParseWhereBind, ParseWhereInit);
+	TableFunction parse_where("parse_where", {LogicalType::VARCHAR},
+	                          InstrumentedTable<PoachedFunction::PARSE_WHERE, WhereCallbacks::Scan>,
+	                          InstrumentedBind<PoachedFunction::PARSE_WHERE, ParseWhereBind>,
+	                          InstrumentedInit<PoachedFunction::PARSE_WHERE, ParseQueryScanInit<WhereCondition>>);
+	parse_where.in_out_function = InstrumentedInOut<PoachedFunction::PARSE_WHERE, WhereCallbacks::InOut>;
+	parse_where.init_local = ParseInOutInitLocal<WhereCondition>;
+	parse_where.projection_pushdown = true;
 	loader.RegisterFunction(parse_where);
 
-	TableFunction parse_columns("parse_columns", {LogicalType::VARCHAR, LogicalType::BIGINT}, ParseColumnsFunc, ParseColumnsBind, ParseColumnsInit);
+	TableFunction parse_columns("parse_columns", {LogicalType::VARCHAR, LogicalType::BIGINT},
+	                            InstrumentedTable<PoachedFunction::PARSE_COLUMNS, ColumnScanCallbacks::Scan>,
+	                            InstrumentedBind<PoachedFunction::PARSE_COLUMNS, ParseColumnsBind>,
+	                            InstrumentedInit<PoachedFunction::PARSE_COLUMNS, ParseColumnsInit>);
+	parse_columns.in_out_function = InstrumentedInOut<PoachedFunction::PARSE_COLUMNS, ColumnInOutCallbacks::InOut>;
+	parse_columns.init_local = ParseInOutInitLocal<ColumnRow>;
+	parse_columns.projection_pushdown = true;
 	loader.RegisterFunction(parse_columns);
 
+	TableFunction parse_lineage("parse_lineage", {LogicalType::VARCHAR},
+	                            InstrumentedTable<PoachedFunction::PARSE_LINEAGE, LineageCallbacks::Scan>,
+	                            InstrumentedBind<PoachedFunction::PARSE_LINEAGE, ParseLineageBind>,
+	                            InstrumentedInit<PoachedFunction::PARSE_LINEAGE, ParseQueryScanInit<LineageRow>>);
+	parse_lineage.in_out_function = InstrumentedInOut<PoachedFunction::PARSE_LINEAGE, LineageCallbacks::InOut>;
+	parse_lineage.init_local = ParseInOutInitLocal<LineageRow>;
+	parse_lineage.projection_pushdown = true;
+	loader.RegisterFunction(parse_lineage);
+
+	TableFunction parse_parameters(
+	    "parse_parameters", {LogicalType::VARCHAR},
+	    InstrumentedTable<PoachedFunction::PARSE_PARAMETERS, ParameterCallbacks::Scan>,
+	    InstrumentedBind<PoachedFunction::PARSE_PARAMETERS, ParseParametersBind>,
+	    InstrumentedInit<PoachedFunction::PARSE_PARAMETERS, ParseQueryScanInit<ParameterRow>>);
+	parse_parameters.in_out_function = InstrumentedInOut<PoachedFunction::PARSE_PARAMETERS, ParameterCallbacks::InOut>;
+	parse_parameters.init_local = ParseInOutInitLocal<ParameterRow>;
+	parse_parameters.projection_pushdown = true;
+	loader.RegisterFunction(parse_parameters);
+
+	TableFunction poached_parse_cache_stats("poached_parse_cache_stats", {}, ParseCacheStatsFunc, ParseCacheStatsBind,
+	                                        ParseCacheStatsInit);
+	loader.RegisterFunction(poached_parse_cache_stats);
+
+	TableFunction poached_stats("poached_stats", {}, PoachedStatsFunc, PoachedStatsBind, PoachedStatsInit);
+	loader.RegisterFunction(poached_stats);
+
 	// Scalar functions
-	ScalarFunction is_valid_sql("is_valid_sql", {LogicalType::VARCHAR}, LogicalType::BOOLEAN, IsValidSqlFunc);
+	child_list_t<LogicalType> delta_children;
+	delta_children.push_back(make_pair("start_index", LogicalType::BIGINT));
+	delta_children.push_back(make_pair("previous_end_index", LogicalType::BIGINT));
+	delta_children.push_back(make_pair("tokens", LogicalType::LIST(TokenStructType())));
+	ScalarFunction parse_tokens_delta(
+	    "parse_tokens_delta",
+	    {LogicalType::VARCHAR, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::ANY},
+	    LogicalType::STRUCT(std::move(delta_children)),
+	    InstrumentedScalar<PoachedFunction::PARSE_TOKENS_DELTA, ParseTokensDeltaFunc>, ParseTokensDeltaBind);
+	parse_tokens_delta.null_handling = FunctionNullHandling::SPECIAL_HANDLING;
+	loader.RegisterFunction(parse_tokens_delta);
+
+	ScalarFunction parse_token_list(
+	    "parse_token_list", {LogicalType::VARCHAR}, LogicalType::LIST(TokenStructType()),
+	    InstrumentedScalar<PoachedFunction::PARSE_TOKEN_LIST, ExecuteDistinct<ParseTokenListFunc>>);
+	loader.RegisterFunction(parse_token_list);
+
+	ScalarFunction is_valid_sql("is_valid_sql", {LogicalType::VARCHAR}, LogicalType::BOOLEAN,
+	                            InstrumentedScalar<PoachedFunction::IS_VALID_SQL, ExecuteDistinct<IsValidSqlFunc>>);
 	loader.RegisterFunction(is_valid_sql);
 
-	ScalarFunction sql_error_message("sql_error_message", {LogicalType::VARCHAR}, LogicalType::VARCHAR, SqlErrorMessageFunc);
+	ScalarFunction sql_error_message(
+	    "sql_error_message", {LogicalType::VARCHAR}, LogicalType::VARCHAR,
+	    InstrumentedScalar<PoachedFunction::SQL_ERROR_MESSAGE, ExecuteDistinct<SqlErrorMessageFunc>>);
 	sql_error_message.null_handling = FunctionNullHandling::SPECIAL_HANDLING;
 	loader.RegisterFunction(sql_error_message);
 
-	ScalarFunction num_statements("num_statements", {LogicalType::VARCHAR}, LogicalType::BIGINT, NumStatementsFunc);
+	ScalarFunction sql_error_position(
+	    "sql_error_position", {LogicalType::VARCHAR}, LogicalType::BIGINT,
+	    InstrumentedScalar<PoachedFunction::SQL_ERROR_POSITION, ExecuteDistinct<SqlErrorPositionFunc>>);
+	loader.RegisterFunction(sql_error_position);
+
+	ScalarFunction num_statements(
+	    "num_statements", {LogicalType::VARCHAR}, LogicalType::BIGINT,
+	    InstrumentedScalar<PoachedFunction::NUM_STATEMENTS, ExecuteDistinct<NumStatementsFunc>>);
 	loader.RegisterFunction(num_statements);
 
-	ScalarFunction is_keyword("is_keyword", {LogicalType::VARCHAR}, LogicalType::BOOLEAN, IsKeywordFunc);
+	ScalarFunction num_parameters(
+	    "num_parameters", {LogicalType::VARCHAR}, LogicalType::BIGINT,
+	    InstrumentedScalar<PoachedFunction::NUM_PARAMETERS, ExecuteDistinct<NumParametersFunc>>);
+	loader.RegisterFunction(num_parameters);
+
+	ScalarFunction is_keyword("is_keyword", {LogicalType::VARCHAR}, LogicalType::BOOLEAN,
+	                          InstrumentedScalar<PoachedFunction::IS_KEYWORD, ExecuteDistinct<IsKeywordFunc>>);
 	loader.RegisterFunction(is_keyword);
 
-	ScalarFunction sql_strip_comments("sql_strip_comments", {LogicalType::VARCHAR}, LogicalType::VARCHAR, SqlStripCommentsFunc);
+	ScalarFunction keyword_category(
+	    "keyword_category", {LogicalType::VARCHAR}, LogicalType::VARCHAR,
+	    InstrumentedScalar<PoachedFunction::KEYWORD_CATEGORY, ExecuteDistinct<KeywordCategoryFunc>>);
+	loader.RegisterFunction(keyword_category);
+
+	ScalarFunction parse_analyze("parse_analyze", {LogicalType::VARCHAR}, ParseAnalyzeType(),
+	                             InstrumentedScalar<PoachedFunction::PARSE_ANALYZE, ExecuteDistinct<ParseAnalyzeFunc>>,
+	                             ParseAnalyzeBind);
+	loader.RegisterFunction(parse_analyze);
+
+	ScalarFunction parse_ast("parse_ast", {LogicalType::VARCHAR}, LogicalType::LIST(AstNodeType()),
+	                         InstrumentedScalar<PoachedFunction::PARSE_AST, ExecuteDistinct<ParseAstFunc>>);
+	loader.RegisterFunction(parse_ast);
+
+	ScalarFunction sql_strip_comments(
+	    "sql_strip_comments", {LogicalType::VARCHAR}, LogicalType::VARCHAR,
+	    InstrumentedScalar<PoachedFunction::SQL_STRIP_COMMENTS, ExecuteDistinct<SqlStripCommentsFunc>>);
 	loader.RegisterFunction(sql_strip_comments);
 
-	ScalarFunction parse_sql_json("parse_sql_json", {LogicalType::VARCHAR}, LogicalType::VARCHAR, SqlParseJsonFunc);
-	loader.RegisterFunction(parse_sql_json);
+	ScalarFunction parse_normalize(
+	    "parse_normalize", {LogicalType::VARCHAR}, LogicalType::VARCHAR,
+	    InstrumentedScalar<PoachedFunction::PARSE_NORMALIZE, ExecuteDistinct<ParseNormalizeFunc>>);
+	loader.RegisterFunction(parse_normalize);
 
-	ScalarFunction sql_parse_json("sql_parse_json", {LogicalType::VARCHAR}, LogicalType::VARCHAR, SqlParseJsonFunc);
-	loader.RegisterFunction(sql_parse_json);
+	ScalarFunction parse_fingerprint(
+	    "parse_fingerprint", {LogicalType::VARCHAR}, LogicalType::UBIGINT,
+	    InstrumentedScalar<PoachedFunction::PARSE_FINGERPRINT, ExecuteDistinct<ParseFingerprintFunc>>);
+	loader.RegisterFunction(parse_fingerprint);
 
-	ScalarFunction parse_table_names("parse_table_names", {LogicalType::VARCHAR}, LogicalType::LIST(LogicalType::VARCHAR), ParseTableNamesFunc);
+	ScalarFunction parse_signature(
+	    "parse_signature", {LogicalType::VARCHAR}, ParseSignatureType(),
+	    InstrumentedScalar<PoachedFunction::PARSE_SIGNATURE, ExecuteDistinct<ParseSignatureFunc>>);
+	loader.RegisterFunction(parse_signature);
+
+	loader.RegisterFunction(ParseSqlJsonFunctions<PoachedFunction::PARSE_SQL_JSON>("parse_sql_json"));
+	loader.RegisterFunction(ParseSqlJsonFunctions<PoachedFunction::SQL_PARSE_JSON>("sql_parse_json"));
+
+	ScalarFunction parse_table_names(
+	    "parse_table_names", {LogicalType::VARCHAR}, LogicalType::LIST(LogicalType::VARCHAR),
+	    InstrumentedScalar<PoachedFunction::PARSE_TABLE_NAMES, ExecuteDistinct<ParseTableNamesFunc>>);
 	loader.RegisterFunction(parse_table_names);
 
-	ScalarFunction parse_keyword_names("parse_keyword_names", {}, LogicalType::LIST(LogicalType::VARCHAR), ParseKeywordNamesFunc);
+	ScalarFunction parse_statement_types(
+	    "parse_statement_types", {LogicalType::VARCHAR}, LogicalType::LIST(LogicalType::VARCHAR),
+	    InstrumentedScalar<PoachedFunction::PARSE_STATEMENT_TYPES, ExecuteDistinct<ParseStatementTypesFunc>>);
+	loader.RegisterFunction(parse_statement_types);
+
+	ScalarFunction parse_keyword_names("parse_keyword_names", {}, LogicalType::LIST(LogicalType::VARCHAR),
+	                                   InstrumentedScalar<PoachedFunction::PARSE_KEYWORD_NAMES, ParseKeywordNamesFunc>);
 	loader.RegisterFunction(parse_keyword_names);
 
-	ScalarFunction parse_function_names("parse_function_names", {LogicalType::VARCHAR}, LogicalType::LIST(LogicalType::VARCHAR), ParseFunctionNamesFunc);
+	ScalarFunction parse_function_names(
+	    "parse_function_names", {LogicalType::VARCHAR}, LogicalType::LIST(LogicalType::VARCHAR),
+	    InstrumentedScalar<PoachedFunction::PARSE_FUNCTION_NAMES, ExecuteDistinct<ParseFunctionNamesFunc>>);
 	loader.RegisterFunction(parse_function_names);
 
-	ScalarFunction parse_column_names("parse_column_names", {LogicalType::VARCHAR, LogicalType::BIGINT},
-	                                  LogicalType::LIST(LogicalType::VARCHAR), ParseColumnNamesFunc);
+	ScalarFunction parse_column_names(
+	    "parse_column_names", {LogicalType::VARCHAR, LogicalType::BIGINT}, LogicalType::LIST(LogicalType::VARCHAR),
+	    InstrumentedScalar<PoachedFunction::PARSE_COLUMN_NAMES, ExecuteDistinct<ParseColumnNamesFunc>>);
 	loader.RegisterFunction(parse_column_names);
+
+	ScalarFunction poached_stats_reset("poached_stats_reset", {}, LogicalType::BOOLEAN, PoachedStatsResetFunc);
+	poached_stats_reset.stability = FunctionStability::VOLATILE;
+	loader.RegisterFunction(poached_stats_reset);
 }
 
 } // namespace duckdb
@@ -0,0 +1,38 @@
+#include "parser_pool.hpp"
+
+namespace duckdb {
+
+//! Parser states kept idle per thread; more are only needed by nested leases
+static constexpr idx_t MAX_IDLE_PARSERS = 4;
+//! Text buffers above this size are released instead of being kept for the next parse
+static constexpr idx_t MAX_POOLED_TEXT_SIZE = 64 * 1024;
+
+static vector<unique_ptr<ParserLease::State>> &IdleParsers() {
+	static thread_local vector<unique_ptr<ParserLease::State>> idle;
+	return idle;
+}
+
+ParserLease::ParserLease() {
+	auto &idle = IdleParsers();
+	if (idle.empty()) {
+		state = make_uniq<State>();
+		return;
+	}
+	state = std::move(idle.back());
+	idle.pop_back();
+}
+
+ParserLease::~ParserLease() {
+	state->parser.statements.clear();
+	if (state->text.capacity() > MAX_POOLED_TEXT_SIZE) {
+		string().swap(state->text);
+	} else {
+		state->text.clear();
+	}
+	auto &idle = IdleParsers();
+	if (idle.size() < MAX_IDLE_PARSERS) {
+		idle.push_back(std::move(state));
+	}
+}
+
+} // namespace duckdb
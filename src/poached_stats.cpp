@@ -0,0 +1,166 @@
+#include "poached_stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace duckdb {
+
+static constexpr const char *POACHED_FUNCTION_NAMES[] = {
+    "tokenize_sql",         "parse_tokens",       "sql_keywords",          "parse_keywords",
+    "parse_statements",     "parse_sql_file",     "parse_sql_file_tables", "parse_tables",
+    "parse_functions",      "parse_where",        "parse_columns",         "parse_tokens_delta",
+    "parse_token_list",     "is_valid_sql",       "sql_error_message",     "sql_error_position",
+    "num_statements",       "is_keyword",         "keyword_category",      "parse_analyze",
+    "parse_ast",            "sql_strip_comments", "parse_normalize",       "parse_fingerprint",
+    "parse_sql_json",       "sql_parse_json",     "parse_table_names",     "parse_keyword_names",
+    "parse_function_names", "parse_column_names", "parse_lineage",         "parse_statement_types",
+    "parse_parameters",     "num_parameters",     "parse_signature"};
+static_assert(sizeof(POACHED_FUNCTION_NAMES) / sizeof(POACHED_FUNCTION_NAMES[0]) == POACHED_FUNCTION_COUNT,
+              "every PoachedFunction needs a name");
+
+static constexpr const char *POACHED_STAT_NAMES[] = {"calls",         "rows",          "bytes_in",
+                                                    "total_time_ns", "parse_time_ns", "tokenize_time_ns",
+                                                    "exceptions",    "cache_hits",    "cache_misses"};
+static_assert(sizeof(POACHED_STAT_NAMES) / sizeof(POACHED_STAT_NAMES[0]) == POACHED_STAT_COUNT,
+              "every PoachedStat needs a name");
+
+const char *PoachedStats::FunctionName(PoachedFunction function) {
+	return POACHED_FUNCTION_NAMES[static_cast<idx_t>(function)];
+}
+
+const char *PoachedStats::StatName(PoachedStat stat) {
+	return POACHED_STAT_NAMES[static_cast<idx_t>(stat)];
+}
+
+#ifdef POACHED_DISABLE_STATS
+
+vector<poached_counters_t> PoachedStats::Snapshot() {
+	return vector<poached_counters_t>();
+}
+
+void PoachedStats::Reset() {
+}
+
+#else
+
+namespace {
+
+//! The counters of one thread. Only the owning thread writes them, other threads only read.
+struct ThreadCounters {
+	std::atomic<uint64_t> values[POACHED_FUNCTION_COUNT][POACHED_STAT_COUNT];
+	//! The function running on the thread, COUNT if none
+	PoachedFunction current = PoachedFunction::COUNT;
+
+	ThreadCounters();
+	~ThreadCounters();
+};
+
+//! The counter blocks of the running threads, plus what exited threads and Reset left behind
+struct StatsRegistry {
+	std::mutex lock;
+	vector<ThreadCounters *> threads;
+	//! Counts of threads that have exited
+	vector<poached_counters_t> retired = vector<poached_counters_t>(POACHED_FUNCTION_COUNT, poached_counters_t {});
+	//! Totals at the last Reset, subtracted from the current totals
+	vector<poached_counters_t> baseline = vector<poached_counters_t>(POACHED_FUNCTION_COUNT, poached_counters_t {});
+
+	static StatsRegistry &Get() {
+		// never destroyed: threads may exit after static destruction
+		static auto registry = new StatsRegistry();
+		return *registry;
+	}
+
+	//! Sum of the retired and running counts (lock must be held)
+	vector<poached_counters_t> TotalsInternal() {
+		auto totals = retired;
+		for (auto thread : threads) {
+			for (idx_t f = 0; f < POACHED_FUNCTION_COUNT; f++) {
+				for (idx_t s = 0; s < POACHED_STAT_COUNT; s++) {
+					totals[f][s] += thread->values[f][s].load(std::memory_order_relaxed);
+				}
+			}
+		}
+		return totals;
+	}
+};
+
+ThreadCounters::ThreadCounters() {
+	for (auto &function : values) {
+		for (auto &value : function) {
+			value.store(0, std::memory_order_relaxed);
+		}
+	}
+	auto &registry = StatsRegistry::Get();
+	std::lock_guard<std::mutex> guard(registry.lock);
+	registry.threads.push_back(this);
+}
+
+ThreadCounters::~ThreadCounters() {
+	auto &registry = StatsRegistry::Get();
+	std::lock_guard<std::mutex> guard(registry.lock);
+	for (idx_t f = 0; f < POACHED_FUNCTION_COUNT; f++) {
+		for (idx_t s = 0; s < POACHED_STAT_COUNT; s++) {
+			registry.retired[f][s] += values[f][s].load(std::memory_order_relaxed);
+		}
+	}
+	registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), this));
+}
+
+} // namespace
+
+static ThreadCounters &LocalCounters() {
+	static thread_local ThreadCounters counters;
+	return counters;
+}
+
+void PoachedStats::Add(PoachedStat stat, uint64_t value) {
+	auto &counters = LocalCounters();
+	if (counters.current == PoachedFunction::COUNT) {
+		return;
+	}
+	// single writer: no atomic read-modify-write needed
+	auto &counter = counters.values[static_cast<idx_t>(counters.current)][static_cast<idx_t>(stat)];
+	counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+uint64_t PoachedStats::Now() {
+	return NumericCast<uint64_t>(
+	    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+	        .count());
+}
+
+PoachedFunction PoachedStats::Enter(PoachedFunction function) {
+	auto &counters = LocalCounters();
+	auto previous = counters.current;
+	counters.current = function;
+	return previous;
+}
+
+void PoachedStats::Exit(PoachedFunction previous, uint64_t start) {
+	Add(PoachedStat::TOTAL_TIME_NS, Now() - start);
+	LocalCounters().current = previous;
+}
+
+vector<poached_counters_t> PoachedStats::Snapshot() {
+	auto &registry = StatsRegistry::Get();
+	std::lock_guard<std::mutex> guard(registry.lock);
+	auto totals = registry.TotalsInternal();
+	for (idx_t f = 0; f < POACHED_FUNCTION_COUNT; f++) {
+		for (idx_t s = 0; s < POACHED_STAT_COUNT; s++) {
+			totals[f][s] -= registry.baseline[f][s];
+		}
+	}
+	return totals;
+}
+
+void PoachedStats::Reset() {
+	auto &registry = StatsRegistry::Get();
+	std::lock_guard<std::mutex> guard(registry.lock);
+	registry.baseline = registry.TotalsInternal();
+}
+
+#endif
+
+} // namespace duckdb
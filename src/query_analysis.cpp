@@ -0,0 +1,754 @@
+#include "query_analysis.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/query_node.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/query_node/set_operation_node.hpp"
+#include "duckdb/parser/query_node/recursive_cte_node.hpp"
+#include "duckdb/parser/result_modifier.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/statement/insert_statement.hpp"
+#include "duckdb/parser/statement/update_statement.hpp"
+#include "duckdb/parser/statement/delete_statement.hpp"
+#include "duckdb/parser/statement/create_statement.hpp"
+#include "duckdb/parser/statement/merge_into_statement.hpp"
+#include "duckdb/parser/statement/copy_statement.hpp"
+#include "duckdb/parser/statement/explain_statement.hpp"
+#include "duckdb/parser/statement/prepare_statement.hpp"
+#include "duckdb/parser/statement/execute_statement.hpp"
+#include "duckdb/parser/statement/call_statement.hpp"
+#include "duckdb/parser/statement/drop_statement.hpp"
+#include "duckdb/parser/statement/alter_statement.hpp"
+#include "duckdb/parser/statement/vacuum_statement.hpp"
+#include "duckdb/parser/statement/set_statement.hpp"
+#include "duckdb/parser/parsed_data/create_table_info.hpp"
+#include "duckdb/parser/parsed_data/create_view_info.hpp"
+#include "duckdb/parser/parsed_data/create_index_info.hpp"
+#include "duckdb/parser/query_node/cte_node.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+#include "duckdb/parser/tableref/table_function_ref.hpp"
+#include "duckdb/parser/tableref/expressionlistref.hpp"
+#include "duckdb/parser/tableref/pivotref.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/expression/comparison_expression.hpp"
+#include "duckdb/parser/expression/conjunction_expression.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/operator_expression.hpp"
+#include "duckdb/parser/expression/between_expression.hpp"
+#include "duckdb/parser/expression/parameter_expression.hpp"
+#include "duckdb/parser/expression/subquery_expression.hpp"
+#include "duckdb/parser/expression/window_expression.hpp"
+
+#include <unordered_set>
+#include <algorithm>
+
+namespace duckdb {
+
+static bool IsAggregateFunction(const string &name) {
+	// Common aggregate functions
+	static const unordered_set<string> aggregates = {
+		"count", "count_star", "sum", "avg", "min", "max",
+		"first", "last", "any_value", "arbitrary",
+		"stddev", "stddev_pop", "stddev_samp",
+		"variance", "var_pop", "var_samp",
+		"covar_pop", "covar_samp", "corr",
+		"string_agg", "group_concat", "listagg",
+		"array_agg", "list", "histogram",
+		"approx_count_distinct", "approx_quantile",
+		"median", "quantile", "quantile_cont", "quantile_disc",
+		"mode", "entropy", "kurtosis", "skewness",
+		"regr_avgx", "regr_avgy", "regr_count", "regr_intercept",
+		"regr_r2", "regr_slope", "regr_sxx", "regr_sxy", "regr_syy",
+		"bit_and", "bit_or", "bit_xor", "bool_and", "bool_or"
+	};
+	string lower_name = name;
+	std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
+	return aggregates.find(lower_name) != aggregates.end();
+}
+
+static string ComparisonTypeToOperator(ExpressionType type) {
+	switch (type) {
+	case ExpressionType::COMPARE_EQUAL: return "=";
+	case ExpressionType::COMPARE_NOTEQUAL: return "!=";
+	case ExpressionType::COMPARE_LESSTHAN: return "<";
+	case ExpressionType::COMPARE_GREATERTHAN: return ">";
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO: return "<=";
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO: return ">=";
+	case ExpressionType::COMPARE_IN: return "IN";
+	case ExpressionType::COMPARE_NOT_IN: return "NOT IN";
+	default: return "?";
+	}
+}
+
+// The column a comparison, IN or BETWEEN compares its other operands with, nullptr if it is not one on a column
+static const string *ComparedColumn(const ParsedExpression &expr) {
+	const ParsedExpression *column = nullptr;
+	switch (expr.GetExpressionClass()) {
+	case ExpressionClass::COMPARISON: {
+		auto &cmp = expr.Cast<ComparisonExpression>();
+		column = cmp.left->GetExpressionClass() == ExpressionClass::COLUMN_REF ? cmp.left.get() : cmp.right.get();
+		break;
+	}
+	case ExpressionClass::OPERATOR: {
+		auto &op = expr.Cast<OperatorExpression>();
+		if ((op.type == ExpressionType::COMPARE_IN || op.type == ExpressionType::COMPARE_NOT_IN) &&
+		    !op.children.empty()) {
+			column = op.children[0].get();
+		}
+		break;
+	}
+	case ExpressionClass::BETWEEN:
+		column = expr.Cast<BetweenExpression>().input.get();
+		break;
+	default:
+		break;
+	}
+	if (!column || column->GetExpressionClass() != ExpressionClass::COLUMN_REF) {
+		return nullptr;
+	}
+	return &column->Cast<ColumnRefExpression>().GetColumnName();
+}
+
+void ValueFilter::Restrict(const unordered_set<string> &accepted) {
+	if (!restricted) {
+		values = accepted;
+		restricted = true;
+		return;
+	}
+	for (auto it = values.begin(); it != values.end();) {
+		if (accepted.find(*it) == accepted.end()) {
+			it = values.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+QueryAnalyzer::QueryAnalyzer(QueryAnalysis &result, AnalysisTarget targets, SpanLocator *spans, NameSink *names,
+                             const FunctionCatalog *functions)
+    : result(result), targets(targets), spans(spans), names(names), functions(functions) {
+}
+
+bool QueryAnalyzer::Collects(AnalysisTarget target) const {
+	return (static_cast<uint8_t>(targets) & static_cast<uint8_t>(target)) != 0;
+}
+
+void QueryAnalyzer::SetTableContexts(const ValueFilter &contexts) {
+	table_contexts = &contexts;
+	// the tables of query bodies are all in one of these contexts; when only collecting tables, expressions are
+	// walked for their subqueries alone
+	skip_bodies = targets == AnalysisTarget::TABLES && !contexts.Accepts("FROM") && !contexts.Accepts("JOIN") &&
+	              !contexts.Accepts("TABLE_FUNCTION");
+}
+
+void QueryAnalyzer::SetFunctionTypes(const ValueFilter &types) {
+	function_types = &types;
+}
+
+void QueryAnalyzer::AddTable(const string &schema, const string &table, const string &context, SourceSpan span) {
+	if (!Collects(AnalysisTarget::TABLES)) {
+		return;
+	}
+	if (table_contexts && !table_contexts->Accepts(context)) {
+		return;
+	}
+	if (names) {
+		names->AddTableName(schema, table);
+		return;
+	}
+	ExtractedTable t;
+	t.schema = schema;
+	t.table = table;
+	t.context = context;
+	t.span = span;
+	result.tables.push_back(std::move(t));
+}
+
+SourceSpan QueryAnalyzer::TargetSpan(const char *keyword, const string &name) {
+	if (!spans || !Collects(AnalysisTarget::TABLES)) {
+		return SourceSpan();
+	}
+	return spans->FindName(stmt_location, keyword, name);
+}
+
+void QueryAnalyzer::VisitStatement(SQLStatement &stmt) {
+	stmt_location = stmt.stmt_location;
+	switch (stmt.type) {
+	case StatementType::SELECT_STATEMENT:
+		VisitSelect(stmt.Cast<SelectStatement>());
+		break;
+	case StatementType::INSERT_STATEMENT: {
+		auto &insert = stmt.Cast<InsertStatement>();
+		AddTable(insert.schema, insert.table, "INSERT", TargetSpan("INTO", insert.table));
+		if (insert.select_statement) {
+			// INSERT ... VALUES is a SELECT * over the VALUES list
+			auto &node = *insert.select_statement->node;
+			if (!insert.columns.empty() && node.type == QueryNodeType::SELECT_NODE) {
+				insert_values = node.Cast<SelectNode>().from_table.get();
+				insert_columns = &insert.columns;
+			}
+			VisitSelect(*insert.select_statement);
+			insert_values = nullptr;
+			insert_columns = nullptr;
+		}
+		if (insert.on_conflict_info && insert.on_conflict_info->set_info) {
+			VisitUpdateSet(*insert.on_conflict_info->set_info);
+		}
+		for (auto &expr : insert.returning_list) {
+			VisitExpression(*expr);
+		}
+		VisitCTEs(insert.cte_map);
+		break;
+	}
+	case StatementType::UPDATE_STATEMENT: {
+		auto &update = stmt.Cast<UpdateStatement>();
+		if (update.table) {
+			VisitTableRef(*update.table, "UPDATE");
+		}
+		if (update.from_table) {
+			VisitTableRef(*update.from_table, "FROM");
+		}
+		if (update.set_info) {
+			VisitUpdateSet(*update.set_info);
+		}
+		for (auto &expr : update.returning_list) {
+			VisitExpression(*expr);
+		}
+		VisitCTEs(update.cte_map);
+		break;
+	}
+	case StatementType::DELETE_STATEMENT: {
+		auto &del = stmt.Cast<DeleteStatement>();
+		if (del.table) {
+			VisitTableRef(*del.table, "DELETE");
+		}
+		for (auto &ref : del.using_clauses) {
+			VisitTableRef(*ref, "USING");
+		}
+		if (del.condition) {
+			VisitWhereClause(*del.condition);
+		}
+		for (auto &expr : del.returning_list) {
+			VisitExpression(*expr);
+		}
+		VisitCTEs(del.cte_map);
+		break;
+	}
+	case StatementType::CREATE_STATEMENT: {
+		auto &create = stmt.Cast<CreateStatement>();
+		if (!create.info) {
+			break;
+		}
+		if (create.info->type == CatalogType::TABLE_ENTRY) {
+			auto &info = create.info->Cast<CreateTableInfo>();
+			AddTable(info.schema, info.table, "CREATE", TargetSpan("TABLE", info.table));
+			if (info.query) {
+				VisitSelect(*info.query);
+			}
+		} else if (create.info->type == CatalogType::VIEW_ENTRY) {
+			auto &info = create.info->Cast<CreateViewInfo>();
+			AddTable(info.schema, info.view_name, "CREATE", TargetSpan("VIEW", info.view_name));
+			if (info.query) {
+				VisitSelect(*info.query);
+			}
+		} else if (create.info->type == CatalogType::INDEX_ENTRY) {
+			auto &info = create.info->Cast<CreateIndexInfo>();
+			AddTable(info.schema, info.table, "INDEX", TargetSpan("ON", info.table));
+		}
+		break;
+	}
+	case StatementType::MERGE_INTO_STATEMENT: {
+		auto &merge = stmt.Cast<MergeIntoStatement>();
+		if (merge.target) {
+			VisitTableRef(*merge.target, "MERGE");
+		}
+		if (merge.source) {
+			VisitTableRef(*merge.source, "USING");
+		}
+		if (merge.join_condition) {
+			VisitExpression(*merge.join_condition);
+		}
+		for (auto &entry : merge.actions) {
+			for (auto &action : entry.second) {
+				if (action->condition) {
+					VisitExpression(*action->condition);
+				}
+				if (action->update_info) {
+					VisitUpdateSet(*action->update_info);
+				}
+				for (auto &expr : action->expressions) {
+					VisitExpression(*expr);
+				}
+			}
+		}
+		for (auto &expr : merge.returning_list) {
+			VisitExpression(*expr);
+		}
+		VisitCTEs(merge.cte_map);
+		break;
+	}
+	case StatementType::COPY_STATEMENT: {
+		auto &copy = stmt.Cast<CopyStatement>();
+		if (!copy.info) {
+			break;
+		}
+		// COPY table TO reads the table, COPY table FROM writes it; COPY (query) TO reads the tables of the query
+		if (!copy.info->table.empty()) {
+			AddTable(copy.info->schema, copy.info->table, copy.info->is_from ? "COPY_TARGET" : "COPY_SOURCE",
+			         TargetSpan("COPY", copy.info->table));
+		} else if (copy.info->select_statement && !skip_bodies) {
+			VisitQueryNode(*copy.info->select_statement);
+		}
+		break;
+	}
+	case StatementType::DROP_STATEMENT: {
+		auto &drop = stmt.Cast<DropStatement>();
+		if (drop.info && (drop.info->type == CatalogType::TABLE_ENTRY || drop.info->type == CatalogType::VIEW_ENTRY)) {
+			auto keyword = drop.info->type == CatalogType::TABLE_ENTRY ? "TABLE" : "VIEW";
+			AddTable(drop.info->schema, drop.info->name, "DROP", TargetSpan(keyword, drop.info->name));
+		}
+		break;
+	}
+	case StatementType::ALTER_STATEMENT: {
+		auto &alter = stmt.Cast<AlterStatement>();
+		if (alter.info && (alter.info->type == AlterType::ALTER_TABLE || alter.info->type == AlterType::ALTER_VIEW)) {
+			auto keyword = alter.info->type == AlterType::ALTER_TABLE ? "TABLE" : "VIEW";
+			AddTable(alter.info->schema, alter.info->name, "ALTER", TargetSpan(keyword, alter.info->name));
+		}
+		break;
+	}
+	case StatementType::VACUUM_STATEMENT: {
+		// ANALYZE is a VACUUM statement that only analyzes
+		auto &vacuum = stmt.Cast<VacuumStatement>();
+		if (vacuum.info && vacuum.info->ref) {
+			VisitTableRef(*vacuum.info->ref, vacuum.info->options.vacuum ? "VACUUM" : "ANALYZE");
+		}
+		break;
+	}
+	// statements wrapping another one, and statements that only bind or call expressions
+	case StatementType::EXPLAIN_STATEMENT: {
+		auto &explain = stmt.Cast<ExplainStatement>();
+		if (explain.stmt) {
+			VisitStatement(*explain.stmt);
+		}
+		break;
+	}
+	case StatementType::PREPARE_STATEMENT: {
+		auto &prepare = stmt.Cast<PrepareStatement>();
+		if (prepare.statement) {
+			VisitStatement(*prepare.statement);
+		}
+		break;
+	}
+	case StatementType::EXECUTE_STATEMENT:
+		for (auto &value : stmt.Cast<ExecuteStatement>().named_values) {
+			VisitExpression(*value.second);
+		}
+		break;
+	case StatementType::CALL_STATEMENT: {
+		auto &call = stmt.Cast<CallStatement>();
+		if (call.function) {
+			VisitExpression(*call.function);
+		}
+		break;
+	}
+	case StatementType::SET_STATEMENT: {
+		auto &set = stmt.Cast<SetStatement>();
+		if (set.set_type == SetType::SET) {
+			auto &value = set.Cast<SetVariableStatement>().value;
+			if (value) {
+				VisitExpression(*value);
+			}
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void QueryAnalyzer::VisitSelect(SelectStatement &select) {
+	if (select.node && !skip_bodies) {
+		VisitQueryNode(*select.node);
+	}
+}
+
+void QueryAnalyzer::VisitQueryNode(QueryNode &node) {
+	switch (node.type) {
+	case QueryNodeType::SELECT_NODE: {
+		auto &select = node.Cast<SelectNode>();
+		for (auto &expr : select.select_list) {
+			VisitExpression(*expr);
+		}
+		if (select.from_table) {
+			VisitTableRef(*select.from_table, "FROM");
+		}
+		if (select.where_clause) {
+			VisitWhereClause(*select.where_clause);
+		}
+		for (auto &expr : select.groups.group_expressions) {
+			VisitExpression(*expr);
+		}
+		if (select.having) {
+			VisitExpression(*select.having);
+		}
+		if (select.qualify) {
+			VisitExpression(*select.qualify);
+		}
+		break;
+	}
+	case QueryNodeType::SET_OPERATION_NODE: {
+		auto &setop = node.Cast<SetOperationNode>();
+		for (auto &child : setop.children) {
+			VisitQueryNode(*child);
+		}
+		break;
+	}
+	case QueryNodeType::RECURSIVE_CTE_NODE: {
+		auto &cte = node.Cast<RecursiveCTENode>();
+		if (cte.left) {
+			VisitQueryNode(*cte.left);
+		}
+		if (cte.right) {
+			VisitQueryNode(*cte.right);
+		}
+		break;
+	}
+	case QueryNodeType::CTE_NODE: {
+		auto &cte = node.Cast<CTENode>();
+		if (cte.query) {
+			VisitQueryNode(*cte.query);
+		}
+		if (cte.child) {
+			VisitQueryNode(*cte.child);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+
+	for (auto &modifier : node.modifiers) {
+		switch (modifier->type) {
+		case ResultModifierType::ORDER_MODIFIER:
+			for (auto &order : modifier->Cast<OrderModifier>().orders) {
+				VisitExpression(*order.expression);
+			}
+			break;
+		case ResultModifierType::DISTINCT_MODIFIER:
+			for (auto &target : modifier->Cast<DistinctModifier>().distinct_on_targets) {
+				VisitExpression(*target);
+			}
+			break;
+		case ResultModifierType::LIMIT_MODIFIER: {
+			auto &limit = modifier->Cast<LimitModifier>();
+			if (limit.limit) {
+				VisitExpression(*limit.limit);
+			}
+			if (limit.offset) {
+				VisitExpression(*limit.offset);
+			}
+			break;
+		}
+		case ResultModifierType::LIMIT_PERCENT_MODIFIER: {
+			auto &limit = modifier->Cast<LimitPercentModifier>();
+			if (limit.limit) {
+				VisitExpression(*limit.limit);
+			}
+			if (limit.offset) {
+				VisitExpression(*limit.offset);
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	VisitCTEs(node.cte_map);
+}
+
+void QueryAnalyzer::VisitCTEs(CommonTableExpressionMap &cte_map) {
+	for (auto &cte : cte_map.map) {
+		if (cte.second && cte.second->query) {
+			VisitSelect(*cte.second->query);
+		}
+	}
+}
+
+void QueryAnalyzer::VisitTableRef(TableRef &ref, const string &context) {
+	switch (ref.type) {
+	case TableReferenceType::BASE_TABLE: {
+		auto &base = ref.Cast<BaseTableRef>();
+		SourceSpan span;
+		if (spans && ref.query_location.IsValid()) {
+			span = spans->ConstructSpan(ref.query_location.GetIndex());
+		}
+		AddTable(base.schema_name, base.table_name, context, span);
+		break;
+	}
+	case TableReferenceType::JOIN: {
+		auto &join = ref.Cast<JoinRef>();
+		if (join.left) {
+			VisitTableRef(*join.left, context);
+		}
+		if (join.right) {
+			VisitTableRef(*join.right, "JOIN");
+		}
+		if (join.condition) {
+			VisitExpression(*join.condition);
+		}
+		break;
+	}
+	case TableReferenceType::SUBQUERY: {
+		auto &subquery = ref.Cast<SubqueryRef>();
+		if (subquery.subquery) {
+			VisitSelect(*subquery.subquery);
+		}
+		break;
+	}
+	case TableReferenceType::TABLE_FUNCTION: {
+		auto &func = ref.Cast<TableFunctionRef>();
+		if (func.function && func.function->type == ExpressionType::FUNCTION) {
+			auto &fn = func.function->Cast<FunctionExpression>();
+			SourceSpan span;
+			if (spans && fn.query_location.IsValid()) {
+				span = spans->ConstructSpan(fn.query_location.GetIndex());
+			}
+			AddTable(fn.schema, fn.function_name, "TABLE_FUNCTION", span);
+			// the table function itself is listed as a table, its arguments may still call functions
+			for (auto &child : fn.children) {
+				VisitExpression(*child);
+			}
+		}
+		break;
+	}
+	case TableReferenceType::PIVOT: {
+		auto &pivot = ref.Cast<PivotRef>();
+		if (pivot.source) {
+			VisitTableRef(*pivot.source, context);
+		}
+		for (auto &aggregate : pivot.aggregates) {
+			VisitExpression(*aggregate);
+		}
+		for (auto &column : pivot.pivots) {
+			for (auto &expr : column.pivot_expressions) {
+				VisitExpression(*expr);
+			}
+			for (auto &entry : column.entries) {
+				if (entry.expr) {
+					VisitExpression(*entry.expr);
+				}
+			}
+			if (column.subquery && !skip_bodies) {
+				VisitQueryNode(*column.subquery);
+			}
+		}
+		break;
+	}
+	case TableReferenceType::EXPRESSION_LIST: {
+		auto &values = ref.Cast<ExpressionListRef>();
+		auto columns = &ref == insert_values ? insert_columns : nullptr;
+		for (auto &row : values.values) {
+			for (idx_t i = 0; i < row.size(); i++) {
+				parameter_column = columns && i < columns->size() ? &(*columns)[i] : nullptr;
+				VisitExpression(*row[i]);
+			}
+		}
+		parameter_column = nullptr;
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void QueryAnalyzer::VisitExpression(const ParsedExpression &expr) {
+	if (skip_bodies) {
+		return;
+	}
+	switch (expr.GetExpressionClass()) {
+	case ExpressionClass::FUNCTION: {
+		auto &fn = expr.Cast<FunctionExpression>();
+		AddFunction(fn, fn.function_name, fn.is_operator ? "operator" : nullptr);
+		break;
+	}
+	case ExpressionClass::WINDOW:
+		// window functions and aggregates with OVER, which are not FunctionExpressions
+		AddFunction(expr, expr.Cast<WindowExpression>().function_name, "window");
+		break;
+	case ExpressionClass::COLUMN_REF: {
+		if (Collects(AnalysisTarget::COLUMNS)) {
+			auto &col = expr.Cast<ColumnRefExpression>();
+			ColumnReference c;
+			if (col.IsQualified()) {
+				c.table = col.GetTableName();
+			}
+			c.column = col.GetColumnName();
+			if (spans && col.query_location.IsValid()) {
+				c.span = spans->ConstructSpan(col.query_location.GetIndex());
+			}
+			result.columns.push_back(std::move(c));
+		}
+		break;
+	}
+	case ExpressionClass::SUBQUERY: {
+		auto &subquery = expr.Cast<SubqueryExpression>();
+		if (subquery.subquery) {
+			VisitSelect(*subquery.subquery);
+		}
+		break;
+	}
+	case ExpressionClass::PARAMETER:
+		AddParameter(expr);
+		break;
+	default:
+		break;
+	}
+	auto outer_column = parameter_column;
+	parameter_column = Collects(AnalysisTarget::PARAMETERS) ? ComparedColumn(expr) : nullptr;
+	ParsedExpressionIterator::EnumerateChildren(expr,
+	                                            [&](const ParsedExpression &child) { VisitExpression(child); });
+	parameter_column = outer_column;
+}
+
+// The SET clause of an UPDATE (or of INSERT ... ON CONFLICT DO UPDATE)
+void QueryAnalyzer::VisitUpdateSet(UpdateSetInfo &set_info) {
+	for (idx_t i = 0; i < set_info.expressions.size(); i++) {
+		parameter_column = i < set_info.columns.size() ? &set_info.columns[i] : nullptr;
+		VisitExpression(*set_info.expressions[i]);
+	}
+	parameter_column = nullptr;
+	if (set_info.condition) {
+		VisitWhereClause(*set_info.condition);
+	}
+}
+
+void QueryAnalyzer::AddParameter(const ParsedExpression &expr) {
+	if (!Collects(AnalysisTarget::PARAMETERS)) {
+		return;
+	}
+	ParameterRef p;
+	p.name = expr.Cast<ParameterExpression>().identifier;
+	if (parameter_column) {
+		p.column = *parameter_column;
+	}
+	p.location = expr.query_location;
+	result.parameters.push_back(std::move(p));
+}
+
+// Record a function call; type nullptr classifies the function by its name
+void QueryAnalyzer::AddFunction(const ParsedExpression &expr, const string &name, const char *type) {
+	if (!Collects(AnalysisTarget::FUNCTIONS)) {
+		return;
+	}
+	if (names) {
+		names->AddFunctionName(name);
+		return;
+	}
+	if (!type) {
+		type = FunctionType(name);
+	}
+	if (function_types && !function_types->Accepts(type)) {
+		return;
+	}
+	FunctionRef f;
+	f.name = name;
+	f.type = type;
+	if (spans) {
+		// operators (and LIKE etc.) are located at the operator, they span their operands as well
+		f.span = spans->ExpressionSpan(expr);
+	}
+	result.functions.push_back(std::move(f));
+}
+
+const char *QueryAnalyzer::FunctionType(const string &name) const {
+	if (functions) {
+		return FunctionKindName(functions->Lookup(name));
+	}
+	return IsAggregateFunction(name) ? "aggregate" : "scalar";
+}
+
+void QueryAnalyzer::VisitWhereClause(const ParsedExpression &expr) {
+	if (Collects(AnalysisTarget::CONDITIONS)) {
+		ExtractConditions(expr);
+	}
+	VisitExpression(expr);
+}
+
+void QueryAnalyzer::ExtractConditions(const ParsedExpression &expr) {
+	if (expr.type == ExpressionType::CONJUNCTION_AND || expr.type == ExpressionType::CONJUNCTION_OR) {
+		auto &conj = expr.Cast<ConjunctionExpression>();
+		for (auto &child : conj.children) {
+			ExtractConditions(*child);
+		}
+		return;
+	}
+
+	if (expr.GetExpressionClass() == ExpressionClass::COMPARISON) {
+		auto &cmp = expr.Cast<ComparisonExpression>();
+		WhereCondition cond;
+		cond.op = ComparisonTypeToOperator(cmp.type);
+		if (spans) {
+			cond.span = spans->ExpressionSpan(cmp);
+		}
+
+		// Try to get column name from left side
+		if (condition_column_names && cmp.left) {
+			if (cmp.left->type == ExpressionType::COLUMN_REF) {
+				cond.column_name = cmp.left->Cast<ColumnRefExpression>().GetColumnName();
+			} else {
+				cond.column_name = cmp.left->ToString();
+			}
+		}
+
+		// Try to get value from right side
+		if (condition_values && cmp.right) {
+			if (cmp.right->type == ExpressionType::VALUE_CONSTANT) {
+				cond.value = cmp.right->Cast<ConstantExpression>().value.ToString();
+			} else {
+				cond.value = cmp.right->ToString();
+			}
+		}
+
+		result.conditions.push_back(std::move(cond));
+	}
+}
+
+const string &GetExpressionName(const ParsedExpression &expr, string &scratch) {
+	if (!expr.alias.empty()) {
+		return expr.alias;
+	}
+	switch (expr.type) {
+	case ExpressionType::COLUMN_REF:
+		return expr.Cast<ColumnRefExpression>().GetColumnName();
+	case ExpressionType::FUNCTION:
+		return expr.Cast<FunctionExpression>().function_name;
+	default:
+		scratch = expr.ToString();
+		return scratch;
+	}
+}
+
+void AnalyzeStatements(const vector<unique_ptr<SQLStatement>> &statements, QueryAnalysis &result,
+                       AnalysisTarget targets, SpanLocator *spans, const FunctionCatalog *functions) {
+	QueryAnalyzer analyzer(result, targets, spans, nullptr, functions);
+	for (auto &stmt : statements) {
+		if (stmt) {
+			analyzer.VisitStatement(*stmt);
+		}
+	}
+}
+
+void AnalyzeNames(const vector<unique_ptr<SQLStatement>> &statements, AnalysisTarget targets, NameSink &names) {
+	QueryAnalysis unused;
+	QueryAnalyzer analyzer(unused, targets, nullptr, &names);
+	for (auto &stmt : statements) {
+		if (stmt) {
+			analyzer.VisitStatement(*stmt);
+		}
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,112 @@
+#include "query_validation.hpp"
+#include "poached_stats.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/transformer.hpp"
+#include "duckdb/common/exception.hpp"
+#include "postgres_parser.hpp"
+
+namespace duckdb {
+
+// Only a $ or a numbered ? lets a statement mix parameter styles, queries with neither are not tokenized
+static bool HasStyledParameter(const string &query) {
+	for (idx_t pos = 0; pos < query.size(); pos++) {
+		if (query[pos] == '$' ||
+		    (query[pos] == '?' && pos + 1 < query.size() && StringUtil::CharacterIsDigit(query[pos + 1]))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// The transformer rejects a statement mixing anonymous (?), positional ($1, ?1) and named ($name) parameters, which
+// the grammar accepts. The styles are told apart by the first bytes of the tokens, per statement.
+static bool MixesParameterStyles(const string &query) {
+	if (!HasStyledParameter(query)) {
+		return false;
+	}
+	static constexpr uint8_t ANONYMOUS = 1, POSITIONAL = 2, NAMED = 4;
+	uint8_t styles = 0;
+	for (auto &token : Parser::Tokenize(query)) {
+		if (token.type == SimplifiedTokenType::SIMPLIFIED_TOKEN_STRING_CONSTANT) {
+			// a $tag$...$tag$ string
+			continue;
+		}
+		auto c = query[token.start];
+		auto next = token.start + 1 < query.size() ? query[token.start + 1] : '\0';
+		uint8_t style;
+		if (c == ';') {
+			styles = 0;
+			continue;
+		} else if (c == '?') {
+			style = StringUtil::CharacterIsDigit(next) ? POSITIONAL : ANONYMOUS;
+		} else if (c == '$' && StringUtil::CharacterIsDigit(next)) {
+			style = POSITIONAL;
+		} else if (c == '$' && (StringUtil::CharacterIsAlpha(next) || next == '_')) {
+			style = NAMED;
+		} else {
+			continue;
+		}
+		styles |= style;
+		if ((styles & (styles - 1)) != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Transform the parse tree as Parser::ParseQuery does, giving the error it would throw, if any
+static bool TransformParseTree(PostgresParser &parser, string &error) {
+	ParserOptions options;
+	Transformer transformer(options);
+	vector<unique_ptr<SQLStatement>> statements;
+	try {
+		transformer.TransformParseTree(parser.parse_tree, statements);
+	} catch (const Exception &e) {
+		PoachedStats::Add(PoachedStat::EXCEPTIONS);
+		error = e.what();
+		return false;
+	}
+	return true;
+}
+
+QueryValidation ValidateQuery(const string &query, bool transform) {
+	QueryValidation result;
+	{
+		PostgresParser::SetPreserveIdentifierCase(ParserOptions().preserve_identifier_case);
+		PostgresParser parser;
+		bool transformed = true;
+		{
+			PoachedStatsTimer timer(PoachedStat::PARSE_TIME_NS);
+			parser.Parse(query);
+			if (parser.success && transform && parser.parse_tree) {
+				transformed = TransformParseTree(parser, result.error);
+			}
+		}
+		if (parser.success) {
+			if (!transformed) {
+				return result;
+			}
+			if (!transform && MixesParameterStyles(query)) {
+				result.error =
+				    ParserException("Mixing parameter styles (?, $1 and $name) in a statement is not supported").what();
+				return result;
+			}
+			result.success = true;
+			result.statement_count = parser.parse_tree ? NumericCast<idx_t>(parser.parse_tree->length) : 0;
+			return result;
+		}
+		result.error = parser.error_message;
+		if (parser.error_location > 0) {
+			result.error_location = NumericCast<idx_t>(parser.error_location - 1);
+		}
+	}
+	// Parser::ParseQuery retries queries containing unicode spaces after stripping them
+	string stripped_query;
+	if (Parser::StripUnicodeSpaces(query, stripped_query)) {
+		return ValidateQuery(stripped_query, transform);
+	}
+	result.error = ParserException::SyntaxError(query, result.error, result.error_location).what();
+	return result;
+}
+
+} // namespace duckdb
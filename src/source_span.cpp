@@ -0,0 +1,311 @@
+#include "source_span.hpp"
+#include "poached_stats.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/parsed_expression.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace duckdb {
+
+idx_t SkipStringLiteral(const char *data, idx_t pos, idx_t size) {
+	auto quote = data[pos];
+	pos++;
+	while (pos < size) {
+		auto end = static_cast<const char *>(memchr(data + pos, quote, size - pos));
+		if (!end) {
+			return size;
+		}
+		pos = NumericCast<idx_t>(end - data) + 1;
+		if (pos >= size || data[pos] != quote) {
+			return pos;
+		}
+		pos++;
+	}
+	return size;
+}
+
+idx_t FindBlockCommentEnd(const char *data, idx_t pos, idx_t size) {
+	while (pos + 1 < size) {
+		auto star = static_cast<const char *>(memchr(data + pos, '*', size - pos - 1));
+		if (!star) {
+			return size;
+		}
+		pos = NumericCast<idx_t>(star - data) + 1;
+		if (data[pos] == '/') {
+			return pos + 1;
+		}
+	}
+	return size;
+}
+
+idx_t SkipSpaceAndComments(const char *data, idx_t pos, idx_t size) {
+	while (pos < size) {
+		if (StringUtil::CharacterIsSpace(data[pos])) {
+			pos++;
+		} else if (pos + 1 < size && data[pos] == '-' && data[pos + 1] == '-') {
+			auto newline = static_cast<const char *>(memchr(data + pos, '\n', size - pos));
+			pos = newline ? NumericCast<idx_t>(newline - data) : size;
+		} else if (pos + 1 < size && data[pos] == '/' && data[pos + 1] == '*') {
+			pos = FindBlockCommentEnd(data, pos + 2, size);
+		} else {
+			break;
+		}
+	}
+	return pos;
+}
+
+static bool IsTagByte(char c) {
+	return StringUtil::CharacterIsAlphaNumeric(c) || c == '_' || static_cast<unsigned char>(c) >= 0x80;
+}
+
+// The position after the dollar-quoted string opened at pos ($$...$$ or $tag$...$tag$), or pos if there is none
+static idx_t SkipDollarQuoted(const char *data, idx_t pos, idx_t size) {
+	auto tag_end = pos + 1;
+	if (tag_end < size && StringUtil::CharacterIsDigit(data[tag_end])) {
+		// a positional parameter
+		return pos;
+	}
+	while (tag_end < size && IsTagByte(data[tag_end])) {
+		tag_end++;
+	}
+	if (tag_end >= size || data[tag_end] != '$') {
+		return pos;
+	}
+	auto tag_size = tag_end + 1 - pos;
+	for (auto body = tag_end + 1; body + tag_size <= size; body++) {
+		auto close = static_cast<const char *>(memchr(data + body, '$', size - body));
+		if (!close) {
+			break;
+		}
+		body = NumericCast<idx_t>(close - data);
+		if (body + tag_size <= size && memcmp(data + body, data + pos, tag_size) == 0) {
+			return body + tag_size;
+		}
+	}
+	return size;
+}
+
+// The position after the run of token text starting at pos: up to whitespace or the start of a comment outside of
+// string literals and quoted identifiers
+static idx_t SkipTokenText(const char *data, idx_t pos, idx_t size) {
+	auto run_start = pos;
+	while (pos < size) {
+		auto c = data[pos];
+		if (StringUtil::CharacterIsSpace(c)) {
+			break;
+		}
+		auto next = pos + 1 < size ? data[pos + 1] : '\0';
+		if ((c == '-' && next == '-') || (c == '/' && next == '*')) {
+			break;
+		}
+		if (c == '\'' && pos == run_start + 1 && (data[run_start] == 'e' || data[run_start] == 'E')) {
+			// an escape string, where backslashes escape quotes
+			for (pos++; pos < size && data[pos] != '\''; pos++) {
+				pos += data[pos] == '\\' ? 1 : 0;
+			}
+			pos = MinValue<idx_t>(pos + 1, size);
+		} else if (c == '\'' || c == '"') {
+			pos = SkipStringLiteral(data, pos, size);
+		} else if (c == '$' && pos == run_start) {
+			pos = MaxValue<idx_t>(SkipDollarQuoted(data, pos, size), pos + 1);
+		} else {
+			pos++;
+		}
+	}
+	return pos;
+}
+
+idx_t TokenTextEnd(const char *data, idx_t start, idx_t next) {
+	auto end = start;
+	auto pos = start;
+	while (pos < next) {
+		// a token only spans several runs of text if it is e.g. a string literal continued on the next line
+		end = SkipTokenText(data, pos, next);
+		pos = SkipSpaceAndComments(data, end, next);
+	}
+	return end;
+}
+
+LineIndex::LineIndex(const string &text) {
+	line_starts.push_back(0);
+	auto data = text.data();
+	auto size = text.size();
+	for (auto pos = static_cast<const char *>(memchr(data, '\n', size)); pos;
+	     pos = static_cast<const char *>(memchr(pos + 1, '\n', size - (pos + 1 - data)))) {
+		line_starts.push_back(NumericCast<idx_t>(pos + 1 - data));
+	}
+}
+
+void LineIndex::Locate(SourceSpan &span) const {
+	auto line = std::upper_bound(line_starts.begin(), line_starts.end(), span.start_byte) - line_starts.begin();
+	span.line = NumericCast<idx_t>(line);
+	span.column = span.start_byte - line_starts[span.line - 1] + 1;
+}
+
+SpanLocator::SpanLocator(const string &query) : query(query) {
+}
+
+void SpanLocator::InitializeTokens() {
+	if (tokenized) {
+		return;
+	}
+	tokenized = true;
+	PoachedStatsTimer timer(PoachedStat::TOKENIZE_TIME_NS);
+	tokens = Parser::Tokenize(query);
+}
+
+idx_t SpanLocator::TokenAt(idx_t pos) const {
+	auto it = std::upper_bound(tokens.begin(), tokens.end(), pos,
+	                           [](idx_t p, const SimplifiedToken &token) { return p < token.start; });
+	return it == tokens.begin() ? 0 : NumericCast<idx_t>(it - tokens.begin() - 1);
+}
+
+idx_t SpanLocator::TokenEnd(idx_t token_idx) const {
+	idx_t next = token_idx + 1 < tokens.size() ? tokens[token_idx + 1].start : query.size();
+	return TokenTextEnd(query.data(), tokens[token_idx].start, next);
+}
+
+bool SpanLocator::TokenIs(idx_t token_idx, char c) const {
+	if (token_idx >= tokens.size()) {
+		return false;
+	}
+	auto start = tokens[token_idx].start;
+	return query[start] == c && TokenEnd(token_idx) == start + 1;
+}
+
+bool SpanLocator::TokenEquals(idx_t token_idx, const string &text) const {
+	if (token_idx >= tokens.size()) {
+		return false;
+	}
+	auto start = tokens[token_idx].start;
+	auto length = TokenEnd(token_idx) - start;
+	if (length >= 2 && query[start] == '"' && query[start + length - 1] == '"') {
+		start++;
+		length -= 2;
+	}
+	return length == text.size() && StringUtil::CIEquals(query.substr(start, length), text);
+}
+
+idx_t SpanLocator::ConstructEndToken(idx_t token_idx) const {
+	auto end = token_idx;
+	if (!TokenIs(end, '(')) {
+		// a qualified name, possibly called
+		while (TokenIs(end + 1, '.') && end + 2 < tokens.size() && !TokenIs(end + 2, '(')) {
+			end += 2;
+		}
+		if (!TokenIs(end + 1, '(')) {
+			return end;
+		}
+		end++;
+	}
+	// find the matching closing parenthesis, or stop at the end of the text
+	idx_t depth = 0;
+	for (; end < tokens.size(); end++) {
+		if (TokenIs(end, '(')) {
+			depth++;
+		} else if (TokenIs(end, ')') && --depth == 0) {
+			return end;
+		}
+	}
+	return tokens.size() - 1;
+}
+
+SourceSpan SpanLocator::Span(idx_t start, idx_t end) {
+	if (!lines) {
+		lines = make_uniq<LineIndex>(query);
+	}
+	while (end > start && StringUtil::CharacterIsSpace(query[end - 1])) {
+		end--;
+	}
+	SourceSpan span;
+	span.start_byte = start;
+	span.end_byte = end;
+	lines->Locate(span);
+	return span;
+}
+
+SourceSpan SpanLocator::RangeSpan(idx_t location, idx_t length) {
+	auto start = MinValue<idx_t>(base + location, query.size());
+	auto end = MinValue<idx_t>(start + length, query.size());
+	while (start < end && StringUtil::CharacterIsSpace(query[start])) {
+		start++;
+	}
+	if (start >= end) {
+		return SourceSpan();
+	}
+	return Span(start, end);
+}
+
+SourceSpan SpanLocator::ConstructSpan(idx_t location) {
+	InitializeTokens();
+	location += base;
+	if (tokens.empty() || location >= query.size()) {
+		return SourceSpan();
+	}
+	return Span(location, TokenEnd(ConstructEndToken(TokenAt(location))));
+}
+
+void SpanLocator::ExpressionRange(const ParsedExpression &expr, idx_t &start, idx_t &end) {
+	if (expr.query_location.IsValid() && base + expr.query_location.GetIndex() < query.size()) {
+		auto location = base + expr.query_location.GetIndex();
+		start = MinValue(start, location);
+		end = MaxValue(end, TokenEnd(ConstructEndToken(TokenAt(location))));
+	}
+	ParsedExpressionIterator::EnumerateChildren(
+	    expr, [&](const ParsedExpression &child) { ExpressionRange(child, start, end); });
+}
+
+SourceSpan SpanLocator::ExpressionSpan(const ParsedExpression &expr) {
+	InitializeTokens();
+	if (tokens.empty()) {
+		return SourceSpan();
+	}
+	idx_t start = query.size();
+	idx_t end = 0;
+	ExpressionRange(expr, start, end);
+	if (start >= end) {
+		return SourceSpan();
+	}
+	return Span(start, end);
+}
+
+SourceSpan SpanLocator::FindName(idx_t from, const char *keyword, const string &name) {
+	InitializeTokens();
+	auto token_idx = TokenAt(base + from);
+	while (token_idx < tokens.size() && !TokenEquals(token_idx, keyword)) {
+		token_idx++;
+	}
+	while (token_idx < tokens.size() && !TokenEquals(token_idx, name)) {
+		token_idx++;
+	}
+	if (token_idx >= tokens.size()) {
+		return SourceSpan();
+	}
+	auto start_idx = token_idx;
+	while (start_idx >= 2 && TokenIs(start_idx - 1, '.')) {
+		start_idx -= 2;
+	}
+	return Span(tokens[start_idx].start, TokenEnd(token_idx));
+}
+
+void SpanLocator::ExtendOverAlias(SourceSpan &span, const string &alias) {
+	if (!span.IsValid() || alias.empty()) {
+		return;
+	}
+	InitializeTokens();
+	auto token_idx = TokenAt(span.end_byte);
+	if (token_idx < tokens.size() && tokens[token_idx].start < span.end_byte) {
+		token_idx++;
+	}
+	if (TokenEquals(token_idx, "AS")) {
+		token_idx++;
+	}
+	if (TokenEquals(token_idx, alias)) {
+		span.end_byte = TokenEnd(token_idx);
+	}
+}
+
+} // namespace duckdb